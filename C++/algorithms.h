@@ -0,0 +1,124 @@
+#ifndef ASSIGNMENTS_DG_ALGORITHMS_H_
+#define ASSIGNMENTS_DG_ALGORITHMS_H_
+
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/intersect.h"
+#include "assignments/dg/packed_graph.h"
+#include "assignments/dg/executor.h"
+
+namespace gdwg {
+
+// Whole-graph algorithms. Each one runs on a PackedGraph; the Graph overloads pack first.
+// Per-node results are dense arrays indexed like nodes, which lists the node values.
+
+template <typename N>
+struct BfsResult {
+  static constexpr std::size_t kUnreachable = std::numeric_limits<std::size_t>::max();
+
+  std::vector<N> nodes;
+  // Hops from the source, or kUnreachable
+  std::vector<std::size_t> distance;
+  // Index of the BFS-tree parent; the source is its own parent, unreached nodes get kUnreachable
+  std::vector<std::size_t> parent;
+};
+
+// Direction-optimising BFS: switches between top-down and bottom-up steps by frontier size
+template <typename N, typename E>
+BfsResult<N> BFS(const gdwg::Graph<N, E>& g, const N& src, gdwg::Executor& pool);
+template <typename N, typename E>
+BfsResult<N> BFS(gdwg::PackedGraph<N, E>& g, const N& src, gdwg::Executor& pool);
+
+template <typename N>
+struct PageRankResult {
+  std::vector<N> nodes;
+  std::vector<double> rank;
+  std::size_t iterations;
+};
+
+// Pull-based power iteration, stopping once the L1 change between iterations drops below tol.
+// When E is arithmetic the (non-negative) weights are the transition weights, otherwise every
+// edge counts once. Rank from nodes without out-edges is spread evenly over all nodes.
+template <typename N, typename E>
+PageRankResult<N> PageRank(const gdwg::Graph<N, E>& g,
+                           double damping = 0.85,
+                           double tol = 1e-6,
+                           std::size_t threads = std::thread::hardware_concurrency(),
+                           std::size_t max_iterations = 100);
+template <typename N, typename E>
+PageRankResult<N> PageRank(gdwg::PackedGraph<N, E>& g,
+                           double damping,
+                           double tol,
+                           gdwg::Executor& pool,
+                           std::size_t max_iterations = 100);
+
+template <typename N>
+struct SccResult {
+  std::vector<N> nodes;
+  // Component ids are topologically ordered: condensation edges only go from lower to higher ids
+  std::vector<std::size_t> component;
+  std::size_t num_components;
+  // Condensation DAG in CSR form, distinct targets sorted per component
+  std::vector<std::size_t> dag_offsets;
+  std::vector<std::size_t> dag_targets;
+};
+
+// Iterative Tarjan, so deep chains cannot overflow the call stack
+template <typename N, typename E>
+SccResult<N> StronglyConnectedComponents(const gdwg::Graph<N, E>& g);
+template <typename N, typename E>
+SccResult<N> StronglyConnectedComponents(const gdwg::PackedGraph<N, E>& g);
+// Parallel variant: trims trivial components, peels the pivot's component with a
+// forward-backward search, then hands the remainder to Tarjan
+template <typename N, typename E>
+SccResult<N> StronglyConnectedComponents(const gdwg::Graph<N, E>& g, gdwg::Executor& pool);
+template <typename N, typename E>
+SccResult<N> StronglyConnectedComponents(gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool);
+
+template <typename N>
+struct WccResult {
+  std::vector<N> nodes;
+  // Labels are dense, numbered by the first node of each component
+  std::vector<std::size_t> component;
+  std::vector<std::size_t> sizes;
+};
+
+// Edge direction is ignored. Edge ranges are split across threads, which merge nodes through a
+// lock-free union-find with path halving and union by rank.
+template <typename N, typename E>
+WccResult<N> WeaklyConnectedComponents(const gdwg::Graph<N, E>& g,
+                                       std::size_t threads = std::thread::hardware_concurrency());
+template <typename N, typename E>
+WccResult<N> WeaklyConnectedComponents(const gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool);
+
+// Triangles in the undirected simple graph underneath g (direction, weights and self loops are
+// ignored). Edges are oriented from lower to higher degree and neighbour runs intersected.
+template <typename N, typename E>
+std::size_t CountTriangles(const gdwg::Graph<N, E>& g,
+                           std::size_t threads = std::thread::hardware_concurrency());
+template <typename N, typename E>
+std::size_t CountTriangles(const gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool);
+
+template <typename N>
+struct CoreResult {
+  std::vector<N> nodes;
+  std::vector<std::size_t> core;
+  std::size_t degeneracy;
+};
+
+// k-core numbers of the same undirected simple graph, by linear-time bucket peeling
+template <typename N, typename E>
+CoreResult<N> CoreNumbers(const gdwg::Graph<N, E>& g,
+                          std::size_t threads = std::thread::hardware_concurrency());
+template <typename N, typename E>
+CoreResult<N> CoreNumbers(const gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool);
+
+}  // namespace gdwg
+
+#include "assignments/dg/algorithms.tpp"
+
+#endif  // ASSIGNMENTS_DG_ALGORITHMS_H_
@@ -0,0 +1,838 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+namespace detail {
+
+// Fixed-size bitset whose bits can be claimed concurrently
+class AtomicBitset {
+ public:
+  explicit AtomicBitset(std::size_t bits) : words_((bits + 63) / 64) {}
+
+  bool Test(std::size_t i) const {
+    return (words_[i / 64].load(std::memory_order_relaxed) >> (i % 64)) & 1U;
+  }
+  // Returns true if this call flipped the bit from 0 to 1
+  bool TestAndSet(std::size_t i) {
+    auto mask = std::uint64_t{1} << (i % 64);
+    if (words_[i / 64].load(std::memory_order_relaxed) & mask) {
+      return false;
+    }
+    return !(words_[i / 64].fetch_or(mask, std::memory_order_relaxed) & mask);
+  }
+  void Clear() {
+    for (auto& word : words_) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::vector<std::atomic<std::uint64_t>> words_;
+};
+
+}  // namespace detail
+}  // namespace gdwg
+
+/////////
+// BFS //
+/////////
+
+template <typename N, typename E>
+gdwg::BfsResult<N>
+gdwg::BFS(const gdwg::Graph<N, E>& g, const N& src, gdwg::Executor& pool) {
+  gdwg::PackedGraph<N, E> packed{g};
+  return gdwg::BFS(packed, src, pool);
+}
+
+template <typename N, typename E>
+gdwg::BfsResult<N> gdwg::BFS(gdwg::PackedGraph<N, E>& g, const N& src, gdwg::Executor& pool) {
+  using NodeId = typename gdwg::PackedGraph<N, E>::NodeId;
+  // Switching thresholds from Beamer et al.
+  constexpr std::size_t kAlpha = 14;
+  constexpr std::size_t kBeta = 24;
+  constexpr auto kUnreachable = gdwg::BfsResult<N>::kUnreachable;
+
+  auto start = g.IndexOf(src);
+  if (!start) {
+    throw std::out_of_range{"Cannot call gdwg::BFS if src doesn't exist in the graph"};
+  }
+
+  auto n = g.NumNodes();
+  gdwg::BfsResult<N> result{g.Nodes(), std::vector<std::size_t>(n, kUnreachable),
+                            std::vector<std::size_t>(n, kUnreachable)};
+  auto& distance = result.distance;
+  auto& parent = result.parent;
+
+  gdwg::detail::AtomicBitset visited{n};
+  gdwg::detail::AtomicBitset frontier_bits{n};
+  gdwg::detail::AtomicBitset next_bits{n};
+  std::vector<std::vector<NodeId>> local(pool.Size());
+  std::vector<std::size_t> local_edges(pool.Size());
+  std::vector<std::size_t> local_found(pool.Size());
+
+  visited.TestAndSet(*start);
+  distance[*start] = 0;
+  parent[*start] = *start;
+  std::vector<NodeId> frontier{*start};
+  std::size_t frontier_size = 1;
+  std::size_t frontier_edges = g.OutDegree(*start);
+  std::size_t unexplored_edges = g.Targets().size() - frontier_edges;
+  bool bottom_up = false;
+
+  for (std::size_t level = 1; frontier_size > 0; ++level) {
+    if (!bottom_up && frontier_edges > unexplored_edges / kAlpha) {
+      g.BuildIncoming();
+      frontier_bits.Clear();
+      for (auto u : frontier) {
+        frontier_bits.TestAndSet(u);
+      }
+      bottom_up = true;
+    } else if (bottom_up && frontier_size < n / kBeta) {
+      frontier.clear();
+      for (std::size_t v = 0; v < n; ++v) {
+        if (frontier_bits.Test(v)) {
+          frontier.push_back(static_cast<NodeId>(v));
+        }
+      }
+      bottom_up = false;
+    }
+
+    std::fill(local_edges.begin(), local_edges.end(), 0);
+    std::fill(local_found.begin(), local_found.end(), 0);
+    if (bottom_up) {
+      // Every unvisited node looks for any parent in the frontier and stops at the first hit
+      next_bits.Clear();
+      pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+        for (auto v = lo; v < hi; ++v) {
+          if (visited.Test(v)) {
+            continue;
+          }
+          auto vid = static_cast<NodeId>(v);
+          for (auto u = g.InNeighborsBegin(vid); u != g.InNeighborsEnd(vid); ++u) {
+            if (frontier_bits.Test(*u)) {
+              visited.TestAndSet(v);
+              next_bits.TestAndSet(v);
+              distance[v] = level;
+              parent[v] = *u;
+              ++local_found[slot];
+              local_edges[slot] += g.OutDegree(vid);
+              break;
+            }
+          }
+        }
+      });
+      std::swap(frontier_bits, next_bits);
+    } else {
+      for (auto& next : local) {
+        next.clear();
+      }
+      pool.ParallelFor(0, frontier.size(), [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+        for (auto i = lo; i < hi; ++i) {
+          auto u = frontier[i];
+          for (auto v = g.NeighborsBegin(u); v != g.NeighborsEnd(u); ++v) {
+            if (visited.TestAndSet(*v)) {
+              distance[*v] = level;
+              parent[*v] = u;
+              local[slot].push_back(*v);
+              local_edges[slot] += g.OutDegree(*v);
+            }
+          }
+        }
+      });
+      frontier.clear();
+      for (const auto& next : local) {
+        frontier.insert(frontier.end(), next.cbegin(), next.cend());
+        local_found[0] += next.size();
+      }
+    }
+
+    frontier_size = 0;
+    frontier_edges = 0;
+    for (std::size_t slot = 0; slot < pool.Size(); ++slot) {
+      frontier_size += local_found[slot];
+      frontier_edges += local_edges[slot];
+    }
+    unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+  }
+  return result;
+}
+
+//////////////
+// PAGERANK //
+//////////////
+
+template <typename N, typename E>
+gdwg::PageRankResult<N> gdwg::PageRank(const gdwg::Graph<N, E>& g,
+                                       double damping,
+                                       double tol,
+                                       std::size_t threads,
+                                       std::size_t max_iterations) {
+  gdwg::PackedGraph<N, E> packed{g};
+  gdwg::Executor pool{threads};
+  return gdwg::PageRank(packed, damping, tol, pool, max_iterations);
+}
+
+template <typename N, typename E>
+gdwg::PageRankResult<N> gdwg::PageRank(gdwg::PackedGraph<N, E>& g,
+                                       double damping,
+                                       double tol,
+                                       gdwg::Executor& pool,
+                                       std::size_t max_iterations) {
+  auto n = g.NumNodes();
+  gdwg::PageRankResult<N> result{g.Nodes(), std::vector<double>(n, n ? 1.0 / n : 0.0), 0};
+  if (n == 0) {
+    return result;
+  }
+  g.BuildIncoming();
+
+  // Slot weight in contiguous incoming order, so the inner loop is a plain dot product
+  const auto& weight_offsets = g.WeightOffsets();
+  std::vector<double> slot_weight(g.Targets().size());
+  for (std::size_t slot = 0; slot < slot_weight.size(); ++slot) {
+    if constexpr (std::is_arithmetic_v<E>) {
+      for (auto w = weight_offsets[slot]; w < weight_offsets[slot + 1]; ++w) {
+        slot_weight[slot] += static_cast<double>(g.Weights()[w]);
+      }
+    } else {
+      slot_weight[slot] = static_cast<double>(weight_offsets[slot + 1] - weight_offsets[slot]);
+    }
+  }
+  std::vector<double> out_weight(n);
+  for (std::size_t u = 0; u < n; ++u) {
+    for (auto slot = g.Offsets()[u]; slot < g.Offsets()[u + 1]; ++slot) {
+      out_weight[u] += slot_weight[slot];
+    }
+  }
+  std::vector<double> in_weight(g.InSlots().size());
+  for (std::size_t i = 0; i < in_weight.size(); ++i) {
+    in_weight[i] = slot_weight[g.InSlots()[i]];
+  }
+  const auto* in_offsets = g.InOffsets().data();
+  const auto* in_sources = g.InSources().data();
+
+  auto& rank = result.rank;
+  std::vector<double> next(n);
+  std::vector<double> scaled(n);
+  std::vector<double> partial(pool.Size());
+  for (std::size_t iter = 0; iter < max_iterations; ++iter) {
+    // rank / out-weight per source; dangling nodes feed the uniform teleport term instead
+    std::fill(partial.begin(), partial.end(), 0.0);
+    pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+      double dangling = 0.0;
+      for (auto u = lo; u < hi; ++u) {
+        if (out_weight[u] > 0.0) {
+          scaled[u] = rank[u] / out_weight[u];
+        } else {
+          scaled[u] = 0.0;
+          dangling += rank[u];
+        }
+      }
+      partial[slot] += dangling;
+    });
+    double dangling = 0.0;
+    for (auto p : partial) {
+      dangling += p;
+    }
+    auto base = (1.0 - damping) / n + damping * dangling / n;
+
+    std::fill(partial.begin(), partial.end(), 0.0);
+    pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+      double delta = 0.0;
+      for (auto v = lo; v < hi; ++v) {
+        double sum = 0.0;
+        for (auto i = in_offsets[v]; i < in_offsets[v + 1]; ++i) {
+          sum += scaled[in_sources[i]] * in_weight[i];
+        }
+        next[v] = base + damping * sum;
+        delta += std::abs(next[v] - rank[v]);
+      }
+      partial[slot] += delta;
+    });
+    rank.swap(next);
+    result.iterations = iter + 1;
+
+    double delta = 0.0;
+    for (auto p : partial) {
+      delta += p;
+    }
+    if (delta < tol) {
+      break;
+    }
+  }
+  return result;
+}
+
+/////////
+// SCC //
+/////////
+
+namespace gdwg {
+namespace detail {
+
+constexpr std::size_t kNoComponent = std::numeric_limits<std::size_t>::max();
+
+// Tarjan over the nodes with active[v] set, writing provisional ids starting at next_id
+template <typename N, typename E>
+void Tarjan(const gdwg::PackedGraph<N, E>& g,
+            const std::vector<char>& active,
+            std::vector<std::size_t>& component,
+            std::size_t& next_id) {
+  using NodeId = typename gdwg::PackedGraph<N, E>::NodeId;
+  constexpr auto kUnvisited = std::numeric_limits<std::size_t>::max();
+
+  auto n = g.NumNodes();
+  std::vector<std::size_t> index(n, kUnvisited);
+  std::vector<std::size_t> lowlink(n);
+  std::vector<char> on_stack(n);
+  std::vector<NodeId> stack;
+  // Explicit call stack of (node, next out-slot to explore)
+  std::vector<std::pair<NodeId, std::size_t>> calls;
+  std::size_t counter = 0;
+
+  for (std::size_t root = 0; root < n; ++root) {
+    if (!active[root] || index[root] != kUnvisited) {
+      continue;
+    }
+    calls.emplace_back(static_cast<NodeId>(root), g.Offsets()[root]);
+    index[root] = lowlink[root] = counter++;
+    stack.push_back(static_cast<NodeId>(root));
+    on_stack[root] = 1;
+
+    while (!calls.empty()) {
+      auto& [v, slot] = calls.back();
+      if (slot < g.Offsets()[v + 1]) {
+        auto w = g.Targets()[slot++];
+        if (!active[w]) {
+          continue;
+        }
+        if (index[w] == kUnvisited) {
+          index[w] = lowlink[w] = counter++;
+          stack.push_back(w);
+          on_stack[w] = 1;
+          calls.emplace_back(w, g.Offsets()[w]);
+        } else if (on_stack[w]) {
+          lowlink[v] = std::min(lowlink[v], index[w]);
+        }
+        continue;
+      }
+
+      auto done = v;
+      calls.pop_back();
+      if (!calls.empty()) {
+        auto caller = calls.back().first;
+        lowlink[caller] = std::min(lowlink[caller], lowlink[done]);
+      }
+      if (lowlink[done] == index[done]) {
+        NodeId w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          on_stack[w] = 0;
+          component[w] = next_id;
+        } while (w != done);
+        ++next_id;
+      }
+    }
+  }
+}
+
+// Nodes reachable from pivot through active nodes, following out- or in-edges
+template <typename N, typename E>
+std::vector<char> Reach(const gdwg::PackedGraph<N, E>& g,
+                        typename gdwg::PackedGraph<N, E>::NodeId pivot,
+                        const std::vector<char>& active,
+                        bool forward,
+                        gdwg::Executor& pool) {
+  using NodeId = typename gdwg::PackedGraph<N, E>::NodeId;
+  gdwg::detail::AtomicBitset seen{g.NumNodes()};
+  std::vector<std::vector<NodeId>> local(pool.Size());
+  std::vector<NodeId> frontier{pivot};
+  seen.TestAndSet(pivot);
+  while (!frontier.empty()) {
+    for (auto& next : local) {
+      next.clear();
+    }
+    pool.ParallelFor(0, frontier.size(), [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+      for (auto i = lo; i < hi; ++i) {
+        auto u = frontier[i];
+        auto begin = forward ? g.NeighborsBegin(u) : g.InNeighborsBegin(u);
+        auto end = forward ? g.NeighborsEnd(u) : g.InNeighborsEnd(u);
+        for (auto v = begin; v != end; ++v) {
+          if (active[*v] && seen.TestAndSet(*v)) {
+            local[slot].push_back(*v);
+          }
+        }
+      }
+    });
+    frontier.clear();
+    for (const auto& next : local) {
+      frontier.insert(frontier.end(), next.cbegin(), next.cend());
+    }
+  }
+  std::vector<char> reached(g.NumNodes());
+  for (std::size_t v = 0; v < reached.size(); ++v) {
+    reached[v] = seen.Test(v);
+  }
+  return reached;
+}
+
+// Builds the condensation from provisional ids and renumbers components topologically
+template <typename N, typename E>
+gdwg::SccResult<N> Condense(const gdwg::PackedGraph<N, E>& g,
+                            std::vector<std::size_t> component,
+                            std::size_t count) {
+  std::vector<std::vector<std::size_t>> out(count);
+  std::vector<std::size_t> in_degree(count);
+  for (std::size_t u = 0; u < g.NumNodes(); ++u) {
+    for (auto slot = g.Offsets()[u]; slot < g.Offsets()[u + 1]; ++slot) {
+      auto cu = component[u];
+      auto cv = component[g.Targets()[slot]];
+      if (cu != cv) {
+        out[cu].push_back(cv);
+      }
+    }
+  }
+  for (auto& targets : out) {
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+    for (auto c : targets) {
+      ++in_degree[c];
+    }
+  }
+
+  // Kahn's algorithm gives the new ids
+  std::vector<std::size_t> order;
+  order.reserve(count);
+  for (std::size_t c = 0; c < count; ++c) {
+    if (in_degree[c] == 0) {
+      order.push_back(c);
+    }
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    for (auto c : out[order[i]]) {
+      if (--in_degree[c] == 0) {
+        order.push_back(c);
+      }
+    }
+  }
+  std::vector<std::size_t> renumber(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    renumber[order[i]] = i;
+  }
+
+  gdwg::SccResult<N> result{g.Nodes(), std::move(component), count, {0}, {}};
+  for (auto& c : result.component) {
+    c = renumber[c];
+  }
+  for (auto c : order) {
+    for (auto target : out[c]) {
+      result.dag_targets.push_back(renumber[target]);
+    }
+    std::sort(result.dag_targets.begin() + result.dag_offsets.back(), result.dag_targets.end());
+    result.dag_offsets.push_back(result.dag_targets.size());
+  }
+  return result;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+gdwg::SccResult<N> gdwg::StronglyConnectedComponents(const gdwg::Graph<N, E>& g) {
+  gdwg::PackedGraph<N, E> packed{g};
+  return gdwg::StronglyConnectedComponents(packed);
+}
+
+template <typename N, typename E>
+gdwg::SccResult<N> gdwg::StronglyConnectedComponents(const gdwg::PackedGraph<N, E>& g) {
+  std::vector<char> active(g.NumNodes(), 1);
+  std::vector<std::size_t> component(g.NumNodes(), gdwg::detail::kNoComponent);
+  std::size_t count = 0;
+  gdwg::detail::Tarjan(g, active, component, count);
+  return gdwg::detail::Condense(g, std::move(component), count);
+}
+
+template <typename N, typename E>
+gdwg::SccResult<N> gdwg::StronglyConnectedComponents(const gdwg::Graph<N, E>& g,
+                                                     gdwg::Executor& pool) {
+  gdwg::PackedGraph<N, E> packed{g};
+  return gdwg::StronglyConnectedComponents(packed, pool);
+}
+
+template <typename N, typename E>
+gdwg::SccResult<N> gdwg::StronglyConnectedComponents(gdwg::PackedGraph<N, E>& g,
+                                                     gdwg::Executor& pool) {
+  // A few trimming rounds catch most trivial components; Tarjan mops up whatever is left
+  constexpr int kTrimRounds = 3;
+
+  g.BuildIncoming();
+  auto n = g.NumNodes();
+  std::vector<char> active(n, 1);
+  std::vector<std::size_t> component(n, gdwg::detail::kNoComponent);
+  std::size_t count = 0;
+
+  auto has_active = [&active](const auto* begin, const auto* end, std::size_t self) {
+    for (auto v = begin; v != end; ++v) {
+      if (active[*v] && *v != self) {
+        return true;
+      }
+    }
+    return false;
+  };
+  std::vector<char> trim(n);
+  for (int round = 0; round < kTrimRounds; ++round) {
+    pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t) {
+      for (auto v = lo; v < hi; ++v) {
+        auto id = static_cast<typename gdwg::PackedGraph<N, E>::NodeId>(v);
+        trim[v] = active[v] && (!has_active(g.NeighborsBegin(id), g.NeighborsEnd(id), v) ||
+                                !has_active(g.InNeighborsBegin(id), g.InNeighborsEnd(id), v));
+      }
+    });
+    std::size_t trimmed = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+      if (trim[v]) {
+        active[v] = 0;
+        component[v] = count++;
+        ++trimmed;
+      }
+    }
+    if (trimmed == 0) {
+      break;
+    }
+  }
+
+  // The pivot with the largest in*out degree usually sits in the giant component
+  std::size_t pivot = n;
+  std::size_t best = 0;
+  for (std::size_t v = 0; v < n; ++v) {
+    auto id = static_cast<typename gdwg::PackedGraph<N, E>::NodeId>(v);
+    auto score = (g.OutDegree(id) + 1) * (g.InDegree(id) + 1);
+    if (active[v] && (pivot == n || score > best)) {
+      pivot = v;
+      best = score;
+    }
+  }
+  if (pivot != n) {
+    auto id = static_cast<typename gdwg::PackedGraph<N, E>::NodeId>(pivot);
+    auto forward = gdwg::detail::Reach(g, id, active, true, pool);
+    auto backward = gdwg::detail::Reach(g, id, active, false, pool);
+    for (std::size_t v = 0; v < n; ++v) {
+      if (forward[v] && backward[v]) {
+        active[v] = 0;
+        component[v] = count;
+      }
+    }
+    ++count;
+  }
+
+  gdwg::detail::Tarjan(g, active, component, count);
+  return gdwg::detail::Condense(g, std::move(component), count);
+}
+
+/////////
+// WCC //
+/////////
+
+namespace gdwg {
+namespace detail {
+
+// Each word packs rank (high half) and parent (low half), so a CAS that links a root also
+// checks its rank has not changed. Roots only ever link towards a higher (rank, id), which
+// rules out cycles between concurrent unions.
+class ConcurrentUnionFind {
+ public:
+  explicit ConcurrentUnionFind(std::size_t n) : words_(n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      words_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  std::uint32_t Find(std::uint32_t x) {
+    while (true) {
+      auto word = words_[x].load(std::memory_order_acquire);
+      auto parent = Parent(word);
+      if (parent == x) {
+        return x;
+      }
+      auto grandparent = Parent(words_[parent].load(std::memory_order_acquire));
+      if (grandparent != parent) {
+        // Path halving; only non-roots are rewritten and their rank never changes
+        words_[x].compare_exchange_weak(word, Pack(Rank(word), grandparent));
+      }
+      x = parent;
+    }
+  }
+
+  void Union(std::uint32_t a, std::uint32_t b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return;
+      }
+      auto word_a = words_[a].load(std::memory_order_acquire);
+      auto word_b = words_[b].load(std::memory_order_acquire);
+      if (Parent(word_a) != a || Parent(word_b) != b) {
+        continue;
+      }
+      // Link the root with the smaller (rank, id) under the other
+      if (Rank(word_a) > Rank(word_b) || (Rank(word_a) == Rank(word_b) && a > b)) {
+        std::swap(a, b);
+        std::swap(word_a, word_b);
+      }
+      if (words_[a].compare_exchange_strong(word_a, Pack(Rank(word_a), b))) {
+        if (Rank(word_a) == Rank(word_b)) {
+          words_[b].compare_exchange_strong(word_b, Pack(Rank(word_b) + 1, b));
+        }
+        return;
+      }
+    }
+  }
+
+ private:
+  static std::uint32_t Parent(std::uint64_t word) { return static_cast<std::uint32_t>(word); }
+  static std::uint64_t Rank(std::uint64_t word) { return word >> 32; }
+  static std::uint64_t Pack(std::uint64_t rank, std::uint32_t parent) {
+    return (rank << 32) | parent;
+  }
+
+  std::vector<std::atomic<std::uint64_t>> words_;
+};
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+gdwg::WccResult<N> gdwg::WeaklyConnectedComponents(const gdwg::Graph<N, E>& g,
+                                                   std::size_t threads) {
+  gdwg::PackedGraph<N, E> packed{g};
+  gdwg::Executor pool{threads};
+  return gdwg::WeaklyConnectedComponents(packed, pool);
+}
+
+template <typename N, typename E>
+gdwg::WccResult<N> gdwg::WeaklyConnectedComponents(const gdwg::PackedGraph<N, E>& g,
+                                                   gdwg::Executor& pool) {
+  auto n = g.NumNodes();
+  gdwg::detail::ConcurrentUnionFind sets{n};
+  const auto& offsets = g.Offsets();
+  const auto& targets = g.Targets();
+
+  // Chunks are ranges of out-slots, so a hub's edges are shared out like anyone else's
+  pool.ParallelFor(0, targets.size(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+    auto src = static_cast<std::size_t>(
+        std::upper_bound(offsets.cbegin(), offsets.cend(), lo) - offsets.cbegin() - 1);
+    for (auto slot = lo; slot < hi; ++slot) {
+      while (slot >= offsets[src + 1]) {
+        ++src;
+      }
+      sets.Union(static_cast<std::uint32_t>(src), targets[slot]);
+    }
+  });
+
+  constexpr auto kUnlabelled = std::numeric_limits<std::size_t>::max();
+  gdwg::WccResult<N> result{g.Nodes(), std::vector<std::size_t>(n), {}};
+  std::vector<std::size_t> label(n, kUnlabelled);
+  for (std::size_t v = 0; v < n; ++v) {
+    auto root = sets.Find(static_cast<std::uint32_t>(v));
+    if (label[root] == kUnlabelled) {
+      label[root] = result.sizes.size();
+      result.sizes.push_back(0);
+    }
+    result.component[v] = label[root];
+    ++result.sizes[label[root]];
+  }
+  return result;
+}
+
+///////////////////////
+// TRIANGLES & CORES //
+///////////////////////
+
+namespace gdwg {
+namespace detail {
+
+// Symmetric, self-loop free adjacency with sorted distinct neighbours
+struct UndirectedView {
+  std::vector<std::size_t> offsets;
+  std::vector<std::uint32_t> adjacency;
+
+  std::size_t Degree(std::size_t v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+template <typename N, typename E>
+UndirectedView Undirected(const gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool) {
+  auto n = g.NumNodes();
+  std::vector<std::size_t> count(n + 1);
+  for (std::size_t u = 0; u < n; ++u) {
+    for (auto slot = g.Offsets()[u]; slot < g.Offsets()[u + 1]; ++slot) {
+      auto v = g.Targets()[slot];
+      if (u != v) {
+        ++count[u + 1];
+        ++count[v + 1];
+      }
+    }
+  }
+  for (std::size_t v = 0; v < n; ++v) {
+    count[v + 1] += count[v];
+  }
+  std::vector<std::uint32_t> both(count[n]);
+  auto cursor = count;
+  for (std::size_t u = 0; u < n; ++u) {
+    for (auto slot = g.Offsets()[u]; slot < g.Offsets()[u + 1]; ++slot) {
+      auto v = g.Targets()[slot];
+      if (u != v) {
+        both[cursor[u]++] = v;
+        both[cursor[v]++] = static_cast<std::uint32_t>(u);
+      }
+    }
+  }
+
+  // Reciprocal edges show up twice, so sort and dedupe each run before compacting
+  std::vector<std::size_t> kept(n);
+  pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t) {
+    for (auto v = lo; v < hi; ++v) {
+      auto begin = both.begin() + static_cast<std::ptrdiff_t>(count[v]);
+      auto end = both.begin() + static_cast<std::ptrdiff_t>(count[v + 1]);
+      std::sort(begin, end);
+      kept[v] = static_cast<std::size_t>(std::unique(begin, end) - begin);
+    }
+  });
+  UndirectedView view{std::vector<std::size_t>(n + 1), {}};
+  for (std::size_t v = 0; v < n; ++v) {
+    view.offsets[v + 1] = view.offsets[v] + kept[v];
+  }
+  view.adjacency.resize(view.offsets[n]);
+  pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t) {
+    for (auto v = lo; v < hi; ++v) {
+      std::copy_n(both.cbegin() + static_cast<std::ptrdiff_t>(count[v]), kept[v],
+                  view.adjacency.begin() + static_cast<std::ptrdiff_t>(view.offsets[v]));
+    }
+  });
+  return view;
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+template <typename N, typename E>
+std::size_t gdwg::CountTriangles(const gdwg::Graph<N, E>& g, std::size_t threads) {
+  gdwg::PackedGraph<N, E> packed{g};
+  gdwg::Executor pool{threads};
+  return gdwg::CountTriangles(packed, pool);
+}
+
+template <typename N, typename E>
+std::size_t gdwg::CountTriangles(const gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool) {
+  auto view = gdwg::detail::Undirected(g, pool);
+  auto n = g.NumNodes();
+  auto before = [&view](std::uint32_t a, std::uint32_t b) {
+    return view.Degree(a) < view.Degree(b) || (view.Degree(a) == view.Degree(b) && a < b);
+  };
+
+  // Keep only edges towards higher-ranked nodes; runs stay sorted by id
+  std::vector<std::size_t> offsets(n + 1);
+  for (std::size_t v = 0; v < n; ++v) {
+    auto id = static_cast<std::uint32_t>(v);
+    offsets[v + 1] = offsets[v] + static_cast<std::size_t>(std::count_if(
+        view.adjacency.cbegin() + static_cast<std::ptrdiff_t>(view.offsets[v]),
+        view.adjacency.cbegin() + static_cast<std::ptrdiff_t>(view.offsets[v + 1]),
+        [&](std::uint32_t w) { return before(id, w); }));
+  }
+  std::vector<std::uint32_t> oriented(offsets[n]);
+  pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t) {
+    for (auto v = lo; v < hi; ++v) {
+      auto id = static_cast<std::uint32_t>(v);
+      std::copy_if(view.adjacency.cbegin() + static_cast<std::ptrdiff_t>(view.offsets[v]),
+                   view.adjacency.cbegin() + static_cast<std::ptrdiff_t>(view.offsets[v + 1]),
+                   oriented.begin() + static_cast<std::ptrdiff_t>(offsets[v]),
+                   [&](std::uint32_t w) { return before(id, w); });
+    }
+  });
+
+  std::vector<std::size_t> partial(pool.Size());
+  pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+    std::size_t triangles = 0;
+    for (auto u = lo; u < hi; ++u) {
+      const auto* u_begin = oriented.data() + offsets[u];
+      const auto* u_end = oriented.data() + offsets[u + 1];
+      for (auto v = u_begin; v != u_end; ++v) {
+        triangles += gdwg::detail::IntersectCount(u_begin, u_end, oriented.data() + offsets[*v],
+                                                  oriented.data() + offsets[*v + 1]);
+      }
+    }
+    partial[slot] += triangles;
+  });
+  std::size_t total = 0;
+  for (auto p : partial) {
+    total += p;
+  }
+  return total;
+}
+
+template <typename N, typename E>
+gdwg::CoreResult<N> gdwg::CoreNumbers(const gdwg::Graph<N, E>& g, std::size_t threads) {
+  gdwg::PackedGraph<N, E> packed{g};
+  gdwg::Executor pool{threads};
+  return gdwg::CoreNumbers(packed, pool);
+}
+
+template <typename N, typename E>
+gdwg::CoreResult<N> gdwg::CoreNumbers(const gdwg::PackedGraph<N, E>& g, gdwg::Executor& pool) {
+  // Batagelj-Zaversnik: nodes sit in an array bucketed by current degree, and peeling a node
+  // moves each higher-degree neighbour one bucket down with a swap
+  auto view = gdwg::detail::Undirected(g, pool);
+  auto n = g.NumNodes();
+  gdwg::CoreResult<N> result{g.Nodes(), std::vector<std::size_t>(n), 0};
+  if (n == 0) {
+    return result;
+  }
+  auto& degree = result.core;
+  std::size_t max_degree = 0;
+  for (std::size_t v = 0; v < n; ++v) {
+    degree[v] = view.Degree(v);
+    max_degree = std::max(max_degree, degree[v]);
+  }
+
+  std::vector<std::size_t> bucket(max_degree + 2);
+  for (auto d : degree) {
+    ++bucket[d + 1];
+  }
+  for (std::size_t d = 0; d <= max_degree; ++d) {
+    bucket[d + 1] += bucket[d];
+  }
+  std::vector<std::size_t> order(n);
+  std::vector<std::size_t> position(n);
+  auto cursor = bucket;
+  for (std::size_t v = 0; v < n; ++v) {
+    position[v] = cursor[degree[v]]++;
+    order[position[v]] = v;
+  }
+
+  for (std::size_t i = 0; i < n; ++i) {
+    auto v = order[i];
+    for (auto j = view.offsets[v]; j < view.offsets[v + 1]; ++j) {
+      auto u = view.adjacency[j];
+      if (degree[u] > degree[v]) {
+        // Swap u with the first node of its bucket, then shrink the bucket past it
+        auto first = bucket[degree[u]];
+        auto w = order[first];
+        if (u != w) {
+          std::swap(order[position[u]], order[first]);
+          std::swap(position[u], position[w]);
+        }
+        ++bucket[degree[u]];
+        --degree[u];
+      }
+    }
+  }
+  result.degeneracy = *std::max_element(degree.cbegin(), degree.cend());
+  return result;
+}
@@ -0,0 +1,391 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The algorithms are checked against small hand-built graphs whose answers can be worked out
+  by hand, and then against larger generated graphs where a simple sequential reference
+  implementation is compared with the parallel result.
+
+  * BFS
+    - src that does not exist
+    - distances and parents on a small graph with an unreachable node
+    - a long chain and a dense star force both top-down and bottom-up steps
+  * PageRank
+    - symmetric cycle gives uniform ranks
+    - arithmetic weights used as transition weights, checked against dense power iteration
+    - non-arithmetic weights count each edge once
+    - dangling nodes and early stopping
+  * StronglyConnectedComponents
+    - two cycles joined by a bridge, with a self loop and an isolated node
+    - a long chain closed into a cycle does not exhaust the stack
+    - the parallel variant agrees with Tarjan on a larger pseudo-random graph
+  * WeaklyConnectedComponents
+    - direction is ignored and labels are dense with matching sizes
+    - many threads racing on a hub-heavy graph agree with a sequential union-find
+  * CountTriangles and CoreNumbers
+    - a 4-clique with reciprocal edges, a self loop and a pendant path
+    - triangle count agrees with brute force on a pseudo-random graph
+
+*/
+
+#include "assignments/dg/algorithms.h"
+
+#include <functional>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+SCENARIO("BFS on a small graph") {
+  GIVEN("A graph with a diamond, a back edge and an isolated node") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("a", "c", 2);
+    g.InsertEdge("b", "d", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("d", "a", 1);
+    gdwg::Executor pool{4};
+    WHEN("BFS is called with a src that is not a node") {
+      THEN("An exception is thrown") {
+        REQUIRE_THROWS_WITH(gdwg::BFS(g, std::string{"z"}, pool),
+                            "Cannot call gdwg::BFS if src doesn't exist in the graph");
+      }
+    }
+    WHEN("BFS is run from a") {
+      auto result = gdwg::BFS(g, std::string{"a"}, pool);
+      THEN("Nodes are reported in increasing order with their hop counts") {
+        REQUIRE(result.nodes == std::vector<std::string>{"a", "b", "c", "d", "e"});
+        REQUIRE(result.distance ==
+                std::vector<std::size_t>{0, 1, 1, 2, gdwg::BfsResult<std::string>::kUnreachable});
+      }
+      THEN("Parents form a shortest-path tree") {
+        REQUIRE(result.parent[0] == 0);
+        REQUIRE(result.parent[1] == 0);
+        REQUIRE(result.parent[2] == 0);
+        REQUIRE((result.parent[3] == 1 || result.parent[3] == 2));
+        REQUIRE(result.parent[4] == gdwg::BfsResult<std::string>::kUnreachable);
+      }
+    }
+  }
+}
+
+SCENARIO("BFS agrees with a sequential search on larger graphs") {
+  GIVEN("A chain joined to a star with many leaves") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 3000; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i < 999; ++i) {
+      g.InsertEdge(i, i + 1, 0);
+    }
+    for (int i = 1000; i < 3000; ++i) {
+      g.InsertEdge(999, i, 0);
+      g.InsertEdge(i, (i * 7) % 3000, 0);
+    }
+    gdwg::PackedGraph<int, int> packed{g};
+    gdwg::Executor pool{4};
+    auto result = gdwg::BFS(packed, 0, pool);
+
+    THEN("Distances match a plain queue-based BFS") {
+      std::vector<std::size_t> expected(3000, gdwg::BfsResult<int>::kUnreachable);
+      std::queue<int> queue;
+      expected[0] = 0;
+      queue.push(0);
+      while (!queue.empty()) {
+        auto u = queue.front();
+        queue.pop();
+        for (auto v : g.GetConnected(u)) {
+          if (expected[v] == gdwg::BfsResult<int>::kUnreachable) {
+            expected[v] = expected[u] + 1;
+            queue.push(v);
+          }
+        }
+      }
+      REQUIRE(result.distance == expected);
+    }
+    THEN("Every parent is one hop closer and has an edge to its child") {
+      for (std::size_t v = 1; v < 3000; ++v) {
+        auto p = result.parent[v];
+        REQUIRE(result.distance[p] + 1 == result.distance[v]);
+        REQUIRE(g.IsConnected(static_cast<int>(p), static_cast<int>(v)));
+      }
+    }
+  }
+}
+
+SCENARIO("PageRank on small graphs") {
+  GIVEN("A directed cycle") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    WHEN("PageRank is run") {
+      auto result = gdwg::PageRank(g, 0.85, 1e-9, 2);
+      THEN("Every node gets the same rank") {
+        for (auto rank : result.rank) {
+          REQUIRE(rank == Approx(1.0 / 3));
+        }
+      }
+    }
+  }
+
+  GIVEN("A weighted graph with a dangling node") {
+    gdwg::Graph<int, double> g{0, 1, 2, 3};
+    g.InsertEdge(0, 1, 3.0);
+    g.InsertEdge(0, 2, 1.0);
+    g.InsertEdge(1, 0, 1.0);
+    g.InsertEdge(1, 2, 0.5);
+    g.InsertEdge(1, 2, 1.5);
+    g.InsertEdge(2, 0, 1.0);
+    g.InsertEdge(2, 3, 1.0);
+    WHEN("PageRank is run to a tight tolerance") {
+      auto result = gdwg::PageRank(g, 0.85, 1e-12, 3, 1000);
+      THEN("It matches a dense power iteration using the summed weights") {
+        double p[4][4] = {{0, 0.75, 0.25, 0}, {1.0 / 3, 0, 2.0 / 3, 0}, {0.5, 0, 0, 0.5}};
+        std::vector<double> rank(4, 0.25);
+        for (int iter = 0; iter < 1000; ++iter) {
+          std::vector<double> next(4, 0.15 / 4 + 0.85 * rank[3] / 4);
+          for (int u = 0; u < 3; ++u) {
+            for (int v = 0; v < 4; ++v) {
+              next[v] += 0.85 * rank[u] * p[u][v];
+            }
+          }
+          rank = next;
+        }
+        for (int v = 0; v < 4; ++v) {
+          REQUIRE(result.rank[v] == Approx(rank[v]));
+        }
+      }
+      THEN("The ranks sum to one") {
+        REQUIRE(result.rank[0] + result.rank[1] + result.rank[2] + result.rank[3] == Approx(1.0));
+      }
+    }
+    WHEN("PageRank is run with a loose tolerance") {
+      auto result = gdwg::PageRank(g, 0.85, 0.1, 2, 1000);
+      THEN("It stops early") { REQUIRE(result.iterations < 10); }
+    }
+  }
+
+  GIVEN("A graph with non-arithmetic weights") {
+    gdwg::Graph<int, std::string> g{0, 1, 2};
+    g.InsertEdge(0, 1, "x");
+    g.InsertEdge(0, 1, "y");
+    g.InsertEdge(0, 2, "z");
+    g.InsertEdge(1, 0, "x");
+    g.InsertEdge(2, 0, "x");
+    WHEN("PageRank is run") {
+      auto result = gdwg::PageRank(g, 0.85, 1e-12, 1, 1000);
+      THEN("Parallel edges count once each") {
+        auto teleport = 0.15 / 3;
+        REQUIRE(result.rank[1] - teleport == Approx(2 * (result.rank[2] - teleport)));
+      }
+    }
+  }
+}
+
+SCENARIO("Strongly connected components of a small graph") {
+  GIVEN("Two cycles joined one way, a self loop and an isolated node") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "f", "g"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("e", "d", 1);
+    g.InsertEdge("f", "f", 1);
+    g.InsertEdge("f", "a", 1);
+    gdwg::Executor pool{2};
+    for (const auto& result :
+         {gdwg::StronglyConnectedComponents(g), gdwg::StronglyConnectedComponents(g, pool)}) {
+      THEN("Cycle members share a component and the rest are singletons") {
+        const auto& c = result.component;
+        REQUIRE(result.num_components == 4);
+        REQUIRE(c[0] == c[1]);
+        REQUIRE(c[1] == c[2]);
+        REQUIRE(c[3] == c[4]);
+        REQUIRE(c[0] != c[3]);
+        REQUIRE(c[5] != c[0]);
+        REQUIRE(c[6] != c[0]);
+      }
+      THEN("The condensation has one edge per joined pair and is topologically numbered") {
+        const auto& c = result.component;
+        REQUIRE(result.dag_targets.size() == 2);
+        REQUIRE(c[5] < c[0]);
+        REQUIRE(c[0] < c[3]);
+        for (std::size_t from = 0; from < result.num_components; ++from) {
+          for (auto i = result.dag_offsets[from]; i < result.dag_offsets[from + 1]; ++i) {
+            REQUIRE(from < result.dag_targets[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Strongly connected components of large graphs") {
+  GIVEN("A chain of 200000 nodes closed into a cycle") {
+    gdwg::Graph<int, int> g;
+    constexpr int kLength = 200000;
+    for (int i = 0; i < kLength; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i < kLength; ++i) {
+      g.InsertEdge(i, (i + 1) % kLength, 0);
+    }
+    WHEN("Tarjan runs over it") {
+      auto result = gdwg::StronglyConnectedComponents(g);
+      THEN("It finds a single component") {
+        REQUIRE(result.num_components == 1);
+        REQUIRE(result.dag_targets.empty());
+      }
+    }
+  }
+
+  GIVEN("A pseudo-random sparse graph") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 2000; ++i) {
+      g.InsertNode(i);
+    }
+    unsigned seed = 7;
+    for (int i = 0; i < 3000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      auto src = static_cast<int>((seed >> 8) % 2000);
+      seed = seed * 1103515245 + 12345;
+      auto dst = static_cast<int>((seed >> 8) % 2000);
+      g.InsertEdge(src, dst, i);
+    }
+    gdwg::Executor pool{4};
+    auto sequential = gdwg::StronglyConnectedComponents(g);
+    auto parallel = gdwg::StronglyConnectedComponents(g, pool);
+    THEN("Both variants find the same partition") {
+      REQUIRE(sequential.num_components == parallel.num_components);
+      std::set<std::pair<std::size_t, std::size_t>> pairs;
+      for (std::size_t v = 0; v < 2000; ++v) {
+        pairs.emplace(sequential.component[v], parallel.component[v]);
+      }
+      REQUIRE(pairs.size() == sequential.num_components);
+    }
+  }
+}
+
+SCENARIO("Weakly connected components") {
+  GIVEN("Three islands joined by edges in both directions") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("b", "a", 1);
+    g.InsertEdge("c", "b", 1);
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("d", "e", 2);
+    WHEN("Components are computed") {
+      auto result = gdwg::WeaklyConnectedComponents(g, 2);
+      THEN("Each island gets a dense label in node order") {
+        REQUIRE(result.component == std::vector<std::size_t>{0, 0, 0, 1, 1, 2});
+        REQUIRE(result.sizes == std::vector<std::size_t>{3, 2, 1});
+      }
+    }
+  }
+
+  GIVEN("A graph of hubs and many small islands") {
+    gdwg::Graph<int, int> g;
+    constexpr int kNodes = 5000;
+    for (int i = 0; i < kNodes; ++i) {
+      g.InsertNode(i);
+    }
+    unsigned seed = 11;
+    for (int i = 0; i < 4000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      auto src = static_cast<int>((seed >> 8) % 50);
+      seed = seed * 1103515245 + 12345;
+      auto dst = static_cast<int>((seed >> 8) % kNodes);
+      g.InsertEdge(src, dst, 0);
+    }
+    auto result = gdwg::WeaklyConnectedComponents(g, 8);
+    THEN("The partition matches a sequential union-find") {
+      std::vector<int> parent(kNodes);
+      for (int i = 0; i < kNodes; ++i) {
+        parent[i] = i;
+      }
+      std::function<int(int)> find = [&](int x) {
+        return parent[x] == x ? x : parent[x] = find(parent[x]);
+      };
+      for (auto it = g.cbegin(); it != g.cend(); ++it) {
+        parent[find(std::get<0>(*it))] = find(std::get<1>(*it));
+      }
+      std::set<std::pair<std::size_t, int>> pairs;
+      std::set<int> roots;
+      for (int v = 0; v < kNodes; ++v) {
+        pairs.emplace(result.component[v], find(v));
+        roots.insert(find(v));
+      }
+      REQUIRE(pairs.size() == roots.size());
+      REQUIRE(result.sizes.size() == roots.size());
+    }
+  }
+}
+
+SCENARIO("Triangle counting and core numbers") {
+  GIVEN("A 4-clique with mixed directions, a self loop and a pendant path") {
+    gdwg::Graph<int, int> g{0, 1, 2, 3, 4, 5};
+    g.InsertEdge(0, 1, 1);
+    g.InsertEdge(1, 0, 1);
+    g.InsertEdge(0, 2, 1);
+    g.InsertEdge(3, 0, 1);
+    g.InsertEdge(1, 2, 1);
+    g.InsertEdge(1, 2, 2);
+    g.InsertEdge(3, 1, 1);
+    g.InsertEdge(2, 3, 1);
+    g.InsertEdge(2, 2, 1);
+    g.InsertEdge(3, 4, 1);
+    g.InsertEdge(5, 4, 1);
+    THEN("The clique contributes four triangles") { REQUIRE(gdwg::CountTriangles(g, 2) == 4); }
+    THEN("Clique members are in the 3-core and the path in the 1-core") {
+      auto result = gdwg::CoreNumbers(g, 2);
+      REQUIRE(result.core == std::vector<std::size_t>{3, 3, 3, 3, 1, 1});
+      REQUIRE(result.degeneracy == 3);
+    }
+  }
+
+  GIVEN("A pseudo-random graph") {
+    constexpr int kNodes = 300;
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < kNodes; ++i) {
+      g.InsertNode(i);
+    }
+    std::vector<std::vector<bool>> adjacent(kNodes, std::vector<bool>(kNodes));
+    unsigned seed = 3;
+    for (int i = 0; i < 3000; ++i) {
+      seed = seed * 1103515245 + 12345;
+      auto src = static_cast<int>((seed >> 8) % kNodes);
+      seed = seed * 1103515245 + 12345;
+      auto dst = static_cast<int>((seed >> 8) % (src < 20 ? kNodes : 40));
+      g.InsertEdge(src, dst, 0);
+      if (src != dst) {
+        adjacent[src][dst] = adjacent[dst][src] = true;
+      }
+    }
+    THEN("The triangle count matches brute force") {
+      std::size_t expected = 0;
+      for (int a = 0; a < kNodes; ++a) {
+        for (int b = a + 1; b < kNodes; ++b) {
+          for (int c = b + 1; c < kNodes; ++c) {
+            expected += adjacent[a][b] && adjacent[b][c] && adjacent[a][c];
+          }
+        }
+      }
+      REQUIRE(gdwg::CountTriangles(g, 4) == expected);
+    }
+    THEN("Every node in the k-core has at least k neighbours inside it") {
+      auto result = gdwg::CoreNumbers(g, 4);
+      for (int v = 0; v < kNodes; ++v) {
+        std::size_t inside = 0;
+        for (int u = 0; u < kNodes; ++u) {
+          inside += adjacent[v][u] && result.core[u] >= result.core[v];
+        }
+        REQUIRE(inside >= result.core[v]);
+      }
+    }
+  }
+}
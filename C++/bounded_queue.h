@@ -0,0 +1,97 @@
+#ifndef ASSIGNMENTS_DG_BOUNDED_QUEUE_H_
+#define ASSIGNMENTS_DG_BOUNDED_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace gdwg {
+
+// Fixed-capacity multi-producer multi-consumer FIFO that never takes a lock (Vyukov's
+// bounded queue). Each cell carries a sequence number saying whether it is ready to be
+// written or read on the current lap, so producers and consumers only contend on their own
+// index. TryPush and TryPop fail instead of blocking; callers decide how to wait, which is
+// what lets a pipeline measure how long each stage spent held up.
+template <typename T>
+class BoundedQueue {
+ public:
+  // capacity is rounded up to a power of two
+  explicit BoundedQueue(std::size_t capacity) : mask_{RoundUp(capacity) - 1} {
+    cells_ = std::make_unique<Cell[]>(mask_ + 1);
+    for (std::size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  std::size_t Capacity() const noexcept { return mask_ + 1; }
+
+  // Moves value in unless the queue is full
+  bool TryPush(T& value) {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells_[pos & mask_];
+      auto sequence = cell.sequence.load(std::memory_order_acquire);
+      auto lap = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (lap == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lap < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Moves the oldest value out unless the queue is empty
+  bool TryPop(T& value) {
+    auto pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells_[pos & mask_];
+      auto sequence = cell.sequence.load(std::memory_order_acquire);
+      auto lap = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+      if (lap == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lap < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  static std::size_t RoundUp(std::size_t n) noexcept {
+    std::size_t size = 2;
+    while (size < n) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  std::size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  // Kept on separate cache lines so producers and consumers don't false-share
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  alignas(64) std::atomic<std::size_t> head_{0};
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_BOUNDED_QUEUE_H_
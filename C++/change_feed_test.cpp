@@ -0,0 +1,225 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The feed exists so derived indexes can follow a graph in O(change) instead of diffing it,
+  so the main test keeps an out-degree cache up to date from events alone and compares it
+  with the graph after every kind of change. The rest checks the guarantees consumers rely on:
+  * Events
+    - one typed event per change that took effect, carrying its values, and none for
+      failed or no-op calls
+    - MergeReplace is a single event rather than the inserts and deletes it is made of
+    - assigning to a graph is a Cleared event followed by its new contents
+    - the graph's counters already include a change when its event arrives
+  * Sequence numbers
+    - start at 1 and go up by one per change, the same with or without subscribers
+  * Subscriptions
+    - several subscribers all see every change; Unsubscribe stops delivery and reports
+      unknown ids
+    - a ChangeCursor queues changes until they are taken, and detaches when destroyed
+
+*/
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+namespace {
+
+using Graph = gdwg::Graph<std::string, int>;
+using Change = gdwg::GraphChange<std::string, int>;
+
+// Out-degree of every node, kept up to date from the feed. Deletes and merges need the
+// edges involved, which the consumer looks up itself once the event arrives.
+class DegreeCache {
+ public:
+  explicit DegreeCache(Graph& g) : g_{g} {
+    for (const auto& node : g.GetNodes()) {
+      degree_[node] = g.OutDegree(node);
+    }
+    id_ = g.Subscribe([this](const Change& change) { Apply(change); });
+  }
+  ~DegreeCache() { g_.Unsubscribe(id_); }
+
+  std::map<std::string, std::size_t> Degrees() const { return degree_; }
+
+ private:
+  void Apply(const Change& change) {
+    std::visit(
+        [this](const auto& e) {
+          using T = std::decay_t<decltype(e)>;
+          if constexpr (std::is_same_v<T, Change::NodeInserted>) {
+            degree_[e.node] = 0;
+          } else if constexpr (std::is_same_v<T, Change::EdgeInserted>) {
+            ++degree_[e.src];
+          } else if constexpr (std::is_same_v<T, Change::EdgeErased>) {
+            --degree_[e.src];
+          } else if constexpr (std::is_same_v<T, Change::NodeDeleted>) {
+            degree_.erase(e.node);
+            Refresh();
+          } else if constexpr (std::is_same_v<T, Change::NodeReplaced>) {
+            degree_[e.new_value] = degree_[e.old_value];
+            degree_.erase(e.old_value);
+          } else if constexpr (std::is_same_v<T, Change::NodesMerged>) {
+            degree_.erase(e.old_value);
+            Refresh();
+          } else {
+            degree_.clear();
+          }
+        },
+        change.event);
+  }
+
+  // Edges into a deleted node vanish with it, so sources that pointed at it are recounted
+  void Refresh() {
+    for (auto& [node, degree] : degree_) {
+      degree = g_.OutDegree(node);
+    }
+  }
+
+  Graph& g_;
+  std::map<std::string, std::size_t> degree_;
+  std::size_t id_;
+};
+
+std::map<std::string, std::size_t> Degrees(const Graph& g) {
+  std::map<std::string, std::size_t> degrees;
+  for (const auto& node : Graph{g}.GetNodes()) {
+    degrees[node] = g.OutDegree(node);
+  }
+  return degrees;
+}
+
+}  // namespace
+
+SCENARIO("Following a graph through its change feed") {
+  GIVEN("A graph with a degree cache subscribed to it") {
+    Graph g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    DegreeCache cache{g};
+
+    WHEN("Every kind of change is made") {
+      THEN("The cache matches the graph after each one") {
+        g.InsertNode("d");
+        g.InsertEdge("d", "a", 2);
+        g.InsertEdges({{"a", "c", 3}, {"b", "d", 4}, {"a", "b", 1}});
+        REQUIRE(cache.Degrees() == Degrees(g));
+        g.erase("a", "b", 1);
+        g.erase(g.find("a", "c", 3));
+        REQUIRE(cache.Degrees() == Degrees(g));
+        g.Replace("d", "dee");
+        REQUIRE(cache.Degrees() == Degrees(g));
+        g.InsertEdge("c", "b", 5);
+        g.InsertEdge("c", "dee", 6);
+        g.MergeReplace("c", "a");
+        REQUIRE(cache.Degrees() == Degrees(g));
+        g.DeleteNode("b");
+        REQUIRE(cache.Degrees() == Degrees(g));
+        g = Graph{"x", "y"};
+        REQUIRE(cache.Degrees() == Degrees(g));
+        g.Clear();
+        REQUIRE(cache.Degrees().empty());
+      }
+    }
+  }
+
+  GIVEN("A graph with a cursor on it") {
+    Graph g{"a", "b"};
+    auto start = g.Sequence();
+    gdwg::ChangeCursor<std::string, int> cursor{g};
+
+    WHEN("Changes succeed, fail or do nothing") {
+      g.InsertEdge("a", "b", 1);
+      g.InsertNode("a");
+      g.InsertEdge("a", "b", 1);
+      g.erase("b", "a", 1);
+      g.DeleteNode("z");
+      REQUIRE_THROWS(g.InsertEdge("a", "z", 1));
+      g.Replace("b", "c");
+      THEN("Only the two that took effect are queued, in order with their values") {
+        REQUIRE(cursor.Pending() == 2);
+        auto first = cursor.Next();
+        REQUIRE(first->sequence == start + 1);
+        const auto& inserted = std::get<Change::EdgeInserted>(first->event);
+        REQUIRE(inserted.src == "a");
+        REQUIRE(inserted.dst == "b");
+        REQUIRE(inserted.weight == 1);
+        auto second = cursor.Next();
+        REQUIRE(second->sequence == start + 2);
+        const auto& replaced = std::get<Change::NodeReplaced>(second->event);
+        REQUIRE(replaced.old_value == "b");
+        REQUIRE(replaced.new_value == "c");
+        REQUIRE_FALSE(cursor.Next().has_value());
+        REQUIRE(g.Sequence() == start + 2);
+      }
+    }
+
+    WHEN("Nodes are merged") {
+      g.InsertEdge("a", "b", 1);
+      g.MergeReplace("a", "b");
+      THEN("The merge is one event") {
+        REQUIRE(cursor.Pending() == 2);
+        cursor.Next();
+        REQUIRE(std::holds_alternative<Change::NodesMerged>(cursor.Next()->event));
+      }
+    }
+
+    WHEN("Another graph is assigned") {
+      Graph other{"p", "q"};
+      other.InsertEdge("p", "q", 3);
+      g = other;
+      THEN("It arrives as a Cleared event and the new contents") {
+        REQUIRE(cursor.Pending() == 4);
+        REQUIRE(std::holds_alternative<Change::Cleared>(cursor.Next()->event));
+        REQUIRE(std::get<Change::NodeInserted>(cursor.Next()->event).node == "p");
+        REQUIRE(std::get<Change::NodeInserted>(cursor.Next()->event).node == "q");
+        REQUIRE(std::get<Change::EdgeInserted>(cursor.Next()->event).weight == 3);
+      }
+    }
+  }
+
+  GIVEN("A subscriber that reads the edge count on every event") {
+    Graph g{"a", "b", "c"};
+    std::vector<std::size_t> counts;
+    g.Subscribe([&g, &counts](const Change&) { counts.push_back(g.NumEdges()); });
+    WHEN("A batch of edges is inserted") {
+      g.InsertEdges({{"a", "b", 1}, {"b", "c", 2}, {"a", "b", 1}});
+      THEN("Each event sees the count including its own edge") {
+        REQUIRE(counts == std::vector<std::size_t>{1, 2});
+      }
+    }
+  }
+
+  GIVEN("Two graphs, only one of them watched") {
+    Graph watched;
+    Graph unwatched;
+    std::vector<std::uint64_t> first;
+    std::vector<std::uint64_t> second;
+    auto id = watched.Subscribe([&first](const Change& c) { first.push_back(c.sequence); });
+    watched.Subscribe([&second](const Change& c) { second.push_back(c.sequence); });
+    for (auto* g : {&watched, &unwatched}) {
+      g->InsertNode("a");
+      g->InsertNode("b");
+      g->InsertEdge("a", "b", 1);
+      *g = Graph{"x"};
+    }
+    THEN("Both count their changes the same way") {
+      REQUIRE(watched.Sequence() == 5);
+      REQUIRE(unwatched.Sequence() == watched.Sequence());
+      REQUIRE(first == std::vector<std::uint64_t>{1, 2, 3, 4, 5});
+      REQUIRE(second == first);
+    }
+    THEN("Unsubscribing stops delivery to that subscriber only") {
+      REQUIRE(watched.Unsubscribe(id));
+      REQUIRE_FALSE(watched.Unsubscribe(id));
+      watched.InsertNode("c");
+      REQUIRE(first.size() == 5);
+      REQUIRE(second.back() == 6);
+    }
+  }
+}
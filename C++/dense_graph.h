@@ -0,0 +1,152 @@
+#ifndef ASSIGNMENTS_DG_DENSE_GRAPH_H_
+#define ASSIGNMENTS_DG_DENSE_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Graph of at most Capacity nodes kept as an adjacency bit matrix, for many small dense graphs
+// where Graph's map and per-edge list nodes cost more than the data.
+//  * IsConnected is one bit test, and neighbours are found by scanning a row a word at a time
+//  * each row is only as wide as the graph has needed so far, so a 20-node graph uses one
+//    word per row whatever Capacity is
+//  * weights live in one vector per src, sorted by dst then weight, so they come out in Graph's
+//    order without sorting
+//  * nodes are found through a sorted vector rather than a map
+// The API and its errors follow Graph's. Inserting a node into a full graph throws.
+template <typename N, typename E, std::size_t Capacity = 4096>
+class DenseGraph {
+  static_assert(Capacity > 0 && Capacity <= std::numeric_limits<std::uint32_t>::max(),
+                "DenseGraph numbers its nodes with 32-bit slots");
+
+ public:
+  static constexpr std::size_t kCapacity = Capacity;
+  static constexpr std::size_t kUnreachable = std::numeric_limits<std::size_t>::max();
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    const_iterator& operator++();
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.src_ == rhs.src_ && lhs.edge_ == rhs.edge_;
+    }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class DenseGraph;
+    const_iterator(const DenseGraph* g, std::size_t src);
+    // Moves to the first edge at or after src_
+    void Settle();
+
+    const DenseGraph* g_ = nullptr;
+    // Position in the node index, then in that node's edges
+    std::size_t src_ = 0;
+    std::size_t edge_ = 0;
+  };
+
+  DenseGraph() = default;
+  DenseGraph(std::initializer_list<N> nodes);
+  // Throws if g has more than Capacity nodes
+  explicit DenseGraph(const gdwg::Graph<N, E>& g);
+
+  bool InsertNode(const N& val);
+  bool InsertEdge(const N& src, const N& dst, const E& w);
+  bool DeleteNode(const N& val) noexcept;
+  bool erase(const N& src, const N& dst, const E& w) noexcept;
+  void Clear() noexcept;
+
+  bool IsNode(const N& val) const noexcept { return Find(val) != kNone; }
+  bool IsConnected(const N& src, const N& dst) const;
+  std::vector<N> GetNodes() const;
+  std::vector<N> GetConnected(const N& src) const;
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+  // Number of out-edges, counting each weight
+  std::size_t OutDegree(const N& src) const;
+  std::size_t size() const noexcept { return index_.size(); }
+  bool empty() const noexcept { return index_.empty(); }
+  std::size_t NumEdges() const noexcept { return num_edges_; }
+
+  // Calls fn(dst) once per distinct out-neighbour of src, in no particular order, by scanning
+  // src's row a word at a time
+  template <typename Fn>
+  void ForEachNeighbor(const N& src, const Fn& fn) const;
+
+  // Hops from src to each node of GetNodes(), or kUnreachable. Each level ORs the frontier's
+  // rows together and masks off visited nodes a word at a time.
+  std::vector<std::size_t> Distances(const N& src) const;
+
+  // Edges as (src, dst, weight) in Graph's order
+  const_iterator cbegin() const { return const_iterator{this, 0}; }
+  const_iterator cend() const { return const_iterator{this, index_.size()}; }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+
+ private:
+  using Slot = std::uint32_t;
+  static constexpr Slot kNone = std::numeric_limits<Slot>::max();
+
+  struct Edge {
+    Slot dst;
+    E weight;
+  };
+
+  Slot Find(const N& val) const noexcept;
+  bool Test(Slot src, Slot dst) const noexcept {
+    return (bits_[src * words_ + dst / 64] >> (dst % 64)) & 1U;
+  }
+  void Set(Slot src, Slot dst) noexcept { bits_[src * words_ + dst / 64] |= Bit(dst); }
+  void Reset(Slot src, Slot dst) noexcept { bits_[src * words_ + dst / 64] &= ~Bit(dst); }
+  static std::uint64_t Bit(Slot slot) noexcept { return std::uint64_t{1} << (slot % 64); }
+  // Orders a row's edges by dst value, then weight
+  bool Before(const Edge& a, const N& dst, const E& w) const {
+    return values_[a.dst] < dst || (!(dst < values_[a.dst]) && a.weight < w);
+  }
+  // Widens every row so slot fits
+  void Widen(Slot slot);
+  // Slots not held by any node
+  std::size_t NumFree() const noexcept { return values_.size() - index_.size(); }
+
+  // Slot -> value; slots of deleted nodes are reused
+  std::vector<N> values_;
+  // The first NumFree() entries are the reusable slots. Sized with values_ rather than grown,
+  // so DeleteNode never allocates, even in a copy.
+  std::vector<Slot> free_;
+  // (value, slot) sorted by value
+  std::vector<std::pair<N, Slot>> index_;
+  // Row per slot, words_ words wide
+  std::vector<std::uint64_t> bits_;
+  std::size_t words_ = 0;
+  std::vector<std::vector<Edge>> edges_;
+  std::size_t num_edges_ = 0;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/dense_graph.tpp"
+
+#endif  // ASSIGNMENTS_DG_DENSE_GRAPH_H_
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/packed_graph.h"
+
+//////////////////
+// CONSTRUCTORS //
+//////////////////
+
+template <typename N, typename E, std::size_t Capacity>
+gdwg::DenseGraph<N, E, Capacity>::DenseGraph(std::initializer_list<N> nodes) {
+  for (const auto& node : nodes) {
+    InsertNode(node);
+  }
+}
+
+// The packed graph already numbers nodes in value order and sorts each node's edges by dst,
+// then weight, so its arrays can be copied across as they are
+template <typename N, typename E, std::size_t Capacity>
+gdwg::DenseGraph<N, E, Capacity>::DenseGraph(const gdwg::Graph<N, E>& g) {
+  if (g.size() > Capacity) {
+    throw std::invalid_argument{
+        "Cannot construct DenseGraph from a graph with more nodes than its capacity"};
+  }
+  gdwg::PackedGraph<N, E> packed{g};
+  auto n = packed.NumNodes();
+  values_ = packed.Nodes();
+  free_.resize(n);
+  index_.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    index_.emplace_back(values_[i], static_cast<Slot>(i));
+  }
+  edges_.resize(n);
+  if (n > 0) {
+    Widen(static_cast<Slot>(n - 1));
+  }
+  for (std::size_t src = 0; src < n; ++src) {
+    auto& row = edges_[src];
+    for (auto slot = packed.Offsets()[src]; slot < packed.Offsets()[src + 1]; ++slot) {
+      auto dst = static_cast<Slot>(packed.Targets()[slot]);
+      Set(static_cast<Slot>(src), dst);
+      for (auto w = packed.WeightOffsets()[slot]; w < packed.WeightOffsets()[slot + 1]; ++w) {
+        row.push_back({dst, packed.Weights()[w]});
+      }
+    }
+  }
+  num_edges_ = packed.NumEdges();
+}
+
+/////////////
+// METHODS //
+/////////////
+
+template <typename N, typename E, std::size_t Capacity>
+typename gdwg::DenseGraph<N, E, Capacity>::Slot
+gdwg::DenseGraph<N, E, Capacity>::Find(const N& val) const noexcept {
+  auto it = std::lower_bound(index_.cbegin(), index_.cend(), val,
+                             [](const auto& entry, const N& v) { return entry.first < v; });
+  return it == index_.cend() || val < it->first ? kNone : it->second;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+void gdwg::DenseGraph<N, E, Capacity>::Widen(Slot slot) {
+  if (slot / 64 >= words_) {
+    // Doubling keeps the total cost of widening linear in the final size
+    auto words = std::max<std::size_t>(words_ * 2, 1);
+    while (words * 64 <= slot) {
+      words *= 2;
+    }
+    words = std::min(words, (Capacity + 63) / 64);
+    std::vector<std::uint64_t> bits(values_.size() * words);
+    for (std::size_t row = 0; row * words_ < bits_.size(); ++row) {
+      std::copy_n(bits_.begin() + static_cast<std::ptrdiff_t>(row * words_), words_,
+                  bits.begin() + static_cast<std::ptrdiff_t>(row * words));
+    }
+    bits_ = std::move(bits);
+    words_ = words;
+  }
+  bits_.resize(values_.size() * words_);
+}
+
+template <typename N, typename E, std::size_t Capacity>
+bool gdwg::DenseGraph<N, E, Capacity>::InsertNode(const N& val) {
+  auto pos = std::lower_bound(index_.begin(), index_.end(), val,
+                              [](const auto& entry, const N& v) { return entry.first < v; });
+  if (pos != index_.end() && !(val < pos->first)) {
+    return false;
+  }
+  if (index_.size() == Capacity) {
+    throw std::runtime_error{"Cannot call DenseGraph::InsertNode on a full graph"};
+  }
+  Slot slot;
+  if (NumFree() > 0) {
+    slot = free_[NumFree() - 1];
+    values_[slot] = val;
+  } else {
+    slot = static_cast<Slot>(values_.size());
+    free_.resize(values_.size() + 1);
+    values_.push_back(val);
+    edges_.emplace_back();
+    Widen(slot);
+  }
+  index_.emplace(pos, val, slot);
+  return true;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+bool gdwg::DenseGraph<N, E, Capacity>::InsertEdge(const N& src, const N& dst, const E& w) {
+  auto s = Find(src);
+  auto d = Find(dst);
+  if (s == kNone || d == kNone) {
+    throw std::runtime_error{
+        "Cannot call Graph::InsertEdge when either src or dst node does not exist"};
+  }
+  auto& row = edges_[s];
+  auto it = std::lower_bound(row.begin(), row.end(), w,
+                             [this, &dst](const Edge& e, const E& v) { return Before(e, dst, v); });
+  if (it != row.end() && it->dst == d && it->weight == w) {
+    return false;
+  }
+  row.insert(it, Edge{d, w});
+  Set(s, d);
+  ++num_edges_;
+  return true;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+bool gdwg::DenseGraph<N, E, Capacity>::DeleteNode(const N& val) noexcept {
+  auto pos = std::lower_bound(index_.begin(), index_.end(), val,
+                              [](const auto& entry, const N& v) { return entry.first < v; });
+  if (pos == index_.end() || val < pos->first) {
+    return false;
+  }
+  auto slot = pos->second;
+  index_.erase(pos);
+  num_edges_ -= edges_[slot].size();
+  edges_[slot].clear();
+  std::fill_n(bits_.begin() + static_cast<std::ptrdiff_t>(slot * words_), words_, 0);
+  // The column says which rows hold edges into the node, so only those are rewritten
+  for (const auto& entry : index_) {
+    auto src = entry.second;
+    if (Test(src, slot)) {
+      auto& row = edges_[src];
+      auto end = std::remove_if(row.begin(), row.end(), [slot](const Edge& e) {
+        return e.dst == slot;
+      });
+      num_edges_ -= static_cast<std::size_t>(row.end() - end);
+      row.erase(end, row.end());
+      Reset(src, slot);
+    }
+  }
+  free_[NumFree() - 1] = slot;
+  return true;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+bool gdwg::DenseGraph<N, E, Capacity>::erase(const N& src, const N& dst, const E& w) noexcept {
+  auto s = Find(src);
+  auto d = Find(dst);
+  if (s == kNone || d == kNone) {
+    return false;
+  }
+  auto& row = edges_[s];
+  auto it = std::lower_bound(row.begin(), row.end(), w,
+                             [this, &dst](const Edge& e, const E& v) { return Before(e, dst, v); });
+  if (it == row.end() || it->dst != d || !(it->weight == w)) {
+    return false;
+  }
+  it = row.erase(it);
+  --num_edges_;
+  // A row's edges to one dst are adjacent, so the bit goes once neither neighbour is to d
+  if ((it == row.end() || it->dst != d) && (it == row.begin() || std::prev(it)->dst != d)) {
+    Reset(s, d);
+  }
+  return true;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+void gdwg::DenseGraph<N, E, Capacity>::Clear() noexcept {
+  values_.clear();
+  free_.clear();
+  index_.clear();
+  bits_.clear();
+  words_ = 0;
+  edges_.clear();
+  num_edges_ = 0;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+bool gdwg::DenseGraph<N, E, Capacity>::IsConnected(const N& src, const N& dst) const {
+  auto s = Find(src);
+  auto d = Find(dst);
+  if (s == kNone || d == kNone) {
+    throw std::runtime_error{
+        "Cannot call Graph::IsConnected if src or dst node don't exist in the graph"};
+  }
+  return Test(s, d);
+}
+
+template <typename N, typename E, std::size_t Capacity>
+std::vector<N> gdwg::DenseGraph<N, E, Capacity>::GetNodes() const {
+  std::vector<N> vec;
+  vec.reserve(index_.size());
+  for (const auto& entry : index_) {
+    vec.push_back(entry.first);
+  }
+  return vec;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+std::vector<N> gdwg::DenseGraph<N, E, Capacity>::GetConnected(const N& src) const {
+  auto s = Find(src);
+  if (s == kNone) {
+    throw std::out_of_range{"Cannot call Graph::GetConnected if src doesn't exist in the graph"};
+  }
+  // The row is sorted by dst value, so the distinct dsts come out in order
+  std::vector<N> vec;
+  const auto& row = edges_[s];
+  for (auto it = row.cbegin(); it != row.cend(); ++it) {
+    if (it == row.cbegin() || std::prev(it)->dst != it->dst) {
+      vec.push_back(values_[it->dst]);
+    }
+  }
+  return vec;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+std::vector<E> gdwg::DenseGraph<N, E, Capacity>::GetWeights(const N& src, const N& dst) const {
+  auto s = Find(src);
+  auto d = Find(dst);
+  if (s == kNone || d == kNone) {
+    throw std::out_of_range{
+        "Cannot call Graph::GetWeights if src or dst node don't exist in the graph"};
+  }
+  std::vector<E> vec;
+  if (!Test(s, d)) {
+    return vec;
+  }
+  const auto& row = edges_[s];
+  auto it = std::lower_bound(row.cbegin(), row.cend(), d, [this, &dst](const Edge& e, Slot) {
+    return values_[e.dst] < dst;
+  });
+  for (; it != row.cend() && it->dst == d; ++it) {
+    vec.push_back(it->weight);
+  }
+  return vec;
+}
+
+template <typename N, typename E, std::size_t Capacity>
+std::size_t gdwg::DenseGraph<N, E, Capacity>::OutDegree(const N& src) const {
+  auto s = Find(src);
+  if (s == kNone) {
+    throw std::out_of_range{"Cannot call Graph::OutDegree if src doesn't exist in the graph"};
+  }
+  return edges_[s].size();
+}
+
+template <typename N, typename E, std::size_t Capacity>
+template <typename Fn>
+void gdwg::DenseGraph<N, E, Capacity>::ForEachNeighbor(const N& src, const Fn& fn) const {
+  auto s = Find(src);
+  if (s == kNone) {
+    throw std::out_of_range{
+        "Cannot call DenseGraph::ForEachNeighbor if src doesn't exist in the graph"};
+  }
+  const auto* row = bits_.data() + s * words_;
+  for (std::size_t w = 0; w < words_; ++w) {
+    for (auto word = row[w]; word != 0; word &= word - 1) {
+      fn(values_[w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))]);
+    }
+  }
+}
+
+template <typename N, typename E, std::size_t Capacity>
+std::vector<std::size_t> gdwg::DenseGraph<N, E, Capacity>::Distances(const N& src) const {
+  auto s = Find(src);
+  if (s == kNone) {
+    throw std::out_of_range{"Cannot call DenseGraph::Distances if src doesn't exist in the graph"};
+  }
+  std::vector<std::size_t> distance(values_.size(), kUnreachable);
+  std::vector<std::uint64_t> visited(words_);
+  std::vector<std::uint64_t> frontier(words_);
+  std::vector<std::uint64_t> next(words_);
+  visited[s / 64] = frontier[s / 64] = Bit(s);
+  distance[s] = 0;
+  for (std::size_t level = 1; std::any_of(frontier.cbegin(), frontier.cend(),
+                                          [](std::uint64_t word) { return word != 0; });
+       ++level) {
+    std::fill(next.begin(), next.end(), 0);
+    for (std::size_t w = 0; w < words_; ++w) {
+      for (auto word = frontier[w]; word != 0; word &= word - 1) {
+        const auto* row =
+            bits_.data() + (w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))) * words_;
+        for (std::size_t i = 0; i < words_; ++i) {
+          next[i] |= row[i];
+        }
+      }
+    }
+    for (std::size_t w = 0; w < words_; ++w) {
+      next[w] &= ~visited[w];
+      visited[w] |= next[w];
+      for (auto word = next[w]; word != 0; word &= word - 1) {
+        distance[w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))] = level;
+      }
+    }
+    frontier.swap(next);
+  }
+
+  std::vector<std::size_t> vec;
+  vec.reserve(index_.size());
+  for (const auto& entry : index_) {
+    vec.push_back(distance[entry.second]);
+  }
+  return vec;
+}
+
+///////////////
+// ITERATORS //
+///////////////
+
+template <typename N, typename E, std::size_t Capacity>
+gdwg::DenseGraph<N, E, Capacity>::const_iterator::const_iterator(const DenseGraph* g,
+                                                                 std::size_t src)
+  : g_{g}, src_{src} {
+  Settle();
+}
+
+template <typename N, typename E, std::size_t Capacity>
+void gdwg::DenseGraph<N, E, Capacity>::const_iterator::Settle() {
+  while (src_ < g_->index_.size() && edge_ == g_->edges_[g_->index_[src_].second].size()) {
+    ++src_;
+    edge_ = 0;
+  }
+}
+
+template <typename N, typename E, std::size_t Capacity>
+typename gdwg::DenseGraph<N, E, Capacity>::const_iterator::reference
+gdwg::DenseGraph<N, E, Capacity>::const_iterator::operator*() const {
+  const auto& entry = g_->index_[src_];
+  const auto& edge = g_->edges_[entry.second][edge_];
+  return {entry.first, g_->values_[edge.dst], edge.weight};
+}
+
+template <typename N, typename E, std::size_t Capacity>
+typename gdwg::DenseGraph<N, E, Capacity>::const_iterator&
+gdwg::DenseGraph<N, E, Capacity>::const_iterator::operator++() {
+  ++edge_;
+  Settle();
+  return *this;
+}
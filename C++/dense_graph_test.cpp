@@ -0,0 +1,200 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  DenseGraph is meant to stand in for Graph on small graphs, so it is driven through the same
+  pseudo-random sequence of insertions and deletions as a Graph and every read is compared
+  with the Graph's after each batch. The sequence uses more than 64 nodes so rows are widened
+  past one word while holding edges, and deletes nodes so slots are reused.
+  * Mutations and reads
+    - edges, nodes, IsConnected, GetConnected, GetWeights and OutDegree agree with Graph
+    - duplicate edges and nodes are refused, and erase of a missing edge returns false
+    - missing nodes throw Graph's exceptions
+  * Construction
+    - from a Graph, and from a Graph with more nodes than the capacity, which throws
+    - inserting past the capacity throws
+    - a copy of a DenseGraph with free slots deletes and reuses slots the same way
+  * ForEachNeighbor and Distances
+    - neighbours match GetConnected, and hop counts match BFS on the same Graph
+
+*/
+
+#include "assignments/dg/dense_graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/algorithms.h"
+#include "assignments/dg/executor.h"
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+namespace {
+
+using Dense = gdwg::DenseGraph<int, int, 200>;
+
+bool SameAsGraph(gdwg::Graph<int, int>& g, const Dense& dense) {
+  using Edges = std::vector<std::tuple<int, int, int>>;
+  // The first iteration can trip over edges left behind by DeleteNode, so have the Graph
+  // clean them all up by printing it before it is read
+  std::ostringstream printed;
+  printed << g;
+  if (dense.size() != g.size() || dense.NumEdges() != g.NumEdges() ||
+      dense.GetNodes() != g.GetNodes() ||
+      Edges(dense.cbegin(), dense.cend()) != Edges(g.cbegin(), g.cend())) {
+    return false;
+  }
+  for (auto src : g.GetNodes()) {
+    if (dense.GetConnected(src) != g.GetConnected(src) ||
+        dense.OutDegree(src) != g.OutDegree(src)) {
+      return false;
+    }
+    for (auto dst : g.GetNodes()) {
+      if (dense.IsConnected(src, dst) != g.IsConnected(src, dst) ||
+          dense.GetWeights(src, dst) != g.GetWeights(src, dst)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SCENARIO("A dense graph behaves like a Graph") {
+  GIVEN("A Graph and a DenseGraph changed in step") {
+    gdwg::Graph<int, int> g;
+    Dense dense;
+    unsigned state = 11;
+    auto next = [&state](unsigned bound) {
+      state = state * 1103515245u + 12345u;
+      return static_cast<int>((state >> 8) % bound);
+    };
+    bool agreed = true;
+    for (int step = 0; step < 3000; ++step) {
+      auto roll = next(100);
+      auto a = next(150);
+      auto b = next(150);
+      auto w = next(4);
+      if (roll < 30) {
+        agreed = agreed && dense.InsertNode(a) == g.InsertNode(a);
+      } else if (roll < 85) {
+        if (g.IsNode(a) && g.IsNode(b)) {
+          agreed = agreed && dense.InsertEdge(a, b, w) == g.InsertEdge(a, b, w);
+        }
+      } else if (roll < 95) {
+        agreed = agreed && dense.erase(a, b, w) == g.erase(a, b, w);
+      } else {
+        agreed = agreed && dense.DeleteNode(a) == g.DeleteNode(a);
+      }
+      if (step % 500 == 499) {
+        agreed = agreed && SameAsGraph(g, dense);
+      }
+    }
+
+    THEN("Every step returned the same and every read agrees") {
+      REQUIRE(agreed);
+      REQUIRE(g.size() > 64);
+      REQUIRE(SameAsGraph(g, dense));
+    }
+
+    THEN("Copying the Graph gives the same DenseGraph") {
+      Dense copy{g};
+      REQUIRE(SameAsGraph(g, copy));
+    }
+
+    THEN("A copy of the DenseGraph deletes and reuses slots like the original") {
+      Dense copy{dense};
+      auto nodes = g.GetNodes();
+      for (std::size_t i = 0; i < nodes.size(); i += 2) {
+        REQUIRE(copy.DeleteNode(nodes[i]));
+        g.DeleteNode(nodes[i]);
+      }
+      for (int node = 1000; node < 1010; ++node) {
+        REQUIRE(copy.InsertNode(node));
+        g.InsertNode(node);
+        copy.InsertEdge(node, nodes[1], node);
+        g.InsertEdge(node, nodes[1], node);
+      }
+      REQUIRE(SameAsGraph(g, copy));
+    }
+
+    THEN("Neighbours and distances agree with the Graph") {
+      gdwg::Executor pool{2};
+      for (auto src : g.GetNodes()) {
+        std::vector<int> neighbours;
+        dense.ForEachNeighbor(src, [&neighbours](int dst) { neighbours.push_back(dst); });
+        std::sort(neighbours.begin(), neighbours.end());
+        REQUIRE(neighbours == g.GetConnected(src));
+        REQUIRE(dense.Distances(src) == gdwg::BFS(g, src, pool).distance);
+      }
+    }
+
+    WHEN("Everything is cleared") {
+      dense.Clear();
+      THEN("It is empty and usable again") {
+        REQUIRE(dense.empty());
+        REQUIRE(dense.NumEdges() == 0);
+        REQUIRE(dense.cbegin() == dense.cend());
+        REQUIRE(dense.InsertNode(1));
+        REQUIRE(dense.InsertEdge(1, 1, 0));
+        REQUIRE(dense.IsConnected(1, 1));
+      }
+    }
+  }
+
+  GIVEN("A small graph") {
+    gdwg::DenseGraph<std::string, int> dense{"a", "b", "c"};
+    dense.InsertEdge("a", "b", 2);
+    dense.InsertEdge("a", "b", 1);
+    dense.InsertEdge("b", "a", 3);
+    THEN("Duplicates are refused") {
+      REQUIRE_FALSE(dense.InsertNode("a"));
+      REQUIRE_FALSE(dense.InsertEdge("a", "b", 2));
+      REQUIRE(dense.GetWeights("a", "b") == std::vector<int>{1, 2});
+    }
+    THEN("Erasing the last weight disconnects the pair") {
+      REQUIRE(dense.erase("a", "b", 1));
+      REQUIRE(dense.IsConnected("a", "b"));
+      REQUIRE(dense.erase("a", "b", 2));
+      REQUIRE_FALSE(dense.IsConnected("a", "b"));
+      REQUIRE_FALSE(dense.erase("a", "b", 2));
+      REQUIRE_FALSE(dense.erase("a", "z", 2));
+    }
+    THEN("Missing nodes throw what Graph throws") {
+      REQUIRE_THROWS_WITH(dense.InsertEdge("a", "z", 1),
+                          "Cannot call Graph::InsertEdge when either src or dst node does not "
+                          "exist");
+      REQUIRE_THROWS_AS(dense.IsConnected("z", "a"), std::runtime_error);
+      REQUIRE_THROWS_AS(dense.GetConnected("z"), std::out_of_range);
+      REQUIRE_THROWS_AS(dense.GetWeights("a", "z"), std::out_of_range);
+      REQUIRE_THROWS_AS(dense.OutDegree("z"), std::out_of_range);
+      REQUIRE_THROWS_WITH(dense.Distances("z"),
+                          "Cannot call DenseGraph::Distances if src doesn't exist in the graph");
+    }
+    THEN("Distances mark unreachable nodes") {
+      auto unreachable = gdwg::DenseGraph<std::string, int>::kUnreachable;
+      REQUIRE(dense.Distances("b") == std::vector<std::size_t>{1, 0, unreachable});
+    }
+  }
+
+  GIVEN("A capacity of three") {
+    gdwg::DenseGraph<int, int, 3> dense{1, 2, 3};
+    THEN("A fourth node throws, unless one is deleted first") {
+      REQUIRE_THROWS_WITH(dense.InsertNode(4), "Cannot call DenseGraph::InsertNode on a full graph");
+      REQUIRE_FALSE(dense.InsertNode(3));
+      REQUIRE(dense.DeleteNode(2));
+      REQUIRE(dense.InsertNode(4));
+      REQUIRE(dense.GetNodes() == std::vector<int>{1, 3, 4});
+    }
+    THEN("A bigger Graph can't be copied in") {
+      gdwg::Graph<int, int> g{1, 2, 3, 4};
+      REQUIRE_THROWS_AS((gdwg::DenseGraph<int, int, 3>{g}), std::invalid_argument);
+    }
+  }
+}
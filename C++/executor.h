@@ -0,0 +1,297 @@
+#ifndef ASSIGNMENTS_DG_EXECUTOR_H_
+#define ASSIGNMENTS_DG_EXECUTOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+// Work-stealing scheduler shared by the parallel algorithms and bulk operations.
+// Each participant owns a deque: it pushes and pops forked work at the back and idle workers
+// steal from the front, so a thread stuck on a hub node sheds the rest of its range to the
+// others instead of a static split leaving them idle. The thread calling ParallelFor or Join
+// takes part as participant 0, so an Executor of size 1 runs everything inline.
+class Executor {
+ public:
+  explicit Executor(std::size_t threads = std::thread::hardware_concurrency())
+    : queues_(std::max<std::size_t>(threads, 1)) {
+    for (std::size_t i = 1; i < queues_.size(); ++i) {
+      workers_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  ~Executor() {
+    {
+      std::lock_guard<std::mutex> lock{sleep_mutex_};
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Number of participants, including the calling thread
+  std::size_t Size() const noexcept { return queues_.size(); }
+
+  // Calls fn(lo, hi, slot) over pieces of [begin, end) no bigger than grain and blocks until
+  // all are done. The range is split in half recursively, so whichever thread runs out of
+  // work first steals the biggest piece left. slot is unique among concurrently running calls
+  // and lies in [0, Size()), so it can index per-thread scratch space.
+  template <typename Fn>
+  void ParallelFor(std::size_t begin, std::size_t end, const Fn& fn, std::size_t grain = 0);
+
+  // Fork-join: runs a and b, possibly in parallel, and returns once both have finished.
+  // Either may call Join or ParallelFor again. If one throws, the exception is rethrown here
+  // after the other has finished.
+  template <typename A, typename B>
+  void Join(const A& a, const B& b);
+
+ private:
+  struct Task {
+    std::function<void()> run;
+    std::atomic<bool> done{false};
+    std::exception_ptr error;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task*> tasks;
+  };
+
+  // Which executor, and which participant of it, the current thread is
+  struct Participant {
+    const Executor* executor = nullptr;
+    std::size_t index = 0;
+  };
+  static Participant& Current() {
+    static thread_local Participant current;
+    return current;
+  }
+
+  template <typename Fn>
+  void Split(std::size_t lo, std::size_t hi, std::size_t grain, const Fn& fn);
+  template <typename Fn>
+  void Enter(const Fn& fn);
+
+  // Spins briefly, then backs off so a long wait doesn't hold a core
+  static void Wait(const Task& task) {
+    for (std::size_t spins = 0; !task.done.load(std::memory_order_acquire); ++spins) {
+      if (spins < 64) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds{50});
+      }
+    }
+  }
+
+  static void Execute(Task* task) {
+    try {
+      task->run();
+    } catch (...) {
+      task->error = std::current_exception();
+    }
+    task->done.store(true, std::memory_order_release);
+  }
+
+  void Push(std::size_t index, Task* task) {
+    {
+      std::lock_guard<std::mutex> lock{queues_[index].mutex};
+      queues_[index].tasks.push_back(task);
+    }
+    pending_.fetch_add(1);
+    if (sleeping_.load() > 0) {
+      std::lock_guard<std::mutex> lock{sleep_mutex_};
+      wake_.notify_one();
+    }
+  }
+
+  // Takes task back off the owner's deque unless a thief already has it
+  bool Reclaim(std::size_t index, Task* task) {
+    std::lock_guard<std::mutex> lock{queues_[index].mutex};
+    auto& tasks = queues_[index].tasks;
+    if (tasks.empty() || tasks.back() != task) {
+      return false;
+    }
+    tasks.pop_back();
+    pending_.fetch_sub(1);
+    return true;
+  }
+
+  Task* Steal(Queue& queue) {
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.tasks.empty()) {
+      return nullptr;
+    }
+    auto* task = queue.tasks.front();
+    queue.tasks.pop_front();
+    pending_.fetch_sub(1);
+    return task;
+  }
+
+  Task* FindWork(std::size_t index, std::uint64_t& rng) {
+    if (auto* task = Steal(injected_)) {
+      return task;
+    }
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    auto start = static_cast<std::size_t>(rng % queues_.size());
+    for (std::size_t i = 0; i < queues_.size(); ++i) {
+      auto victim = (start + i) % queues_.size();
+      if (victim == index) {
+        continue;
+      }
+      if (auto* task = Steal(queues_[victim])) {
+        return task;
+      }
+    }
+    return nullptr;
+  }
+
+  void WorkerLoop(std::size_t index) {
+    Current() = {this, index};
+    std::uint64_t rng = 0x9e3779b97f4a7c15ULL * (index + 1);
+    while (true) {
+      if (auto* task = FindWork(index, rng)) {
+        Execute(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock{sleep_mutex_};
+      sleeping_.fetch_add(1);
+      wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+      sleeping_.fetch_sub(1);
+      if (stopping_) {
+        return;
+      }
+    }
+  }
+
+  std::vector<Queue> queues_;
+  // Work from outside callers that found participant 0 busy
+  Queue injected_;
+  std::vector<std::thread> workers_;
+  // Held by whichever outside thread is acting as participant 0
+  std::mutex outside_;
+
+  std::atomic<std::size_t> pending_{0};
+  std::atomic<std::size_t> sleeping_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+};
+
+template <typename Fn>
+void Executor::ParallelFor(std::size_t begin, std::size_t end, const Fn& fn, std::size_t grain) {
+  if (begin >= end) {
+    return;
+  }
+  if (grain == 0) {
+    // Enough pieces per participant for stealing to even out skewed work
+    grain = std::max<std::size_t>((end - begin) / (Size() * 16), 1);
+  }
+  Enter([&] { Split(begin, end, grain, fn); });
+}
+
+template <typename Fn>
+void Executor::Split(std::size_t lo, std::size_t hi, std::size_t grain, const Fn& fn) {
+  if (hi - lo <= grain) {
+    fn(lo, hi, Current().index);
+    return;
+  }
+  auto mid = lo + (hi - lo) / 2;
+  Join([&] { Split(lo, mid, grain, fn); }, [&] { Split(mid, hi, grain, fn); });
+}
+
+template <typename A, typename B>
+void Executor::Join(const A& a, const B& b) {
+  if (Current().executor != this) {
+    Enter([&] { Join(a, b); });
+    return;
+  }
+  auto index = Current().index;
+  Task forked;
+  forked.run = [&b] { b(); };
+  Push(index, &forked);
+
+  std::exception_ptr error;
+  try {
+    a();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  if (Reclaim(index, &forked)) {
+    Execute(&forked);
+  } else {
+    // A thief has it. Only work forked below this point may be run here, since anything older
+    // could belong to a call this thread is already in the middle of, and nothing is, so wait.
+    Wait(forked);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if (forked.error) {
+    std::rethrow_exception(forked.error);
+  }
+}
+
+// Runs fn as a participant of this executor. Threads already taking part just run it. An
+// outside thread becomes participant 0 if that is free; otherwise its work is handed to the
+// workers and it waits.
+template <typename Fn>
+void Executor::Enter(const Fn& fn) {
+  if (Current().executor == this) {
+    fn();
+    return;
+  }
+  std::unique_lock<std::mutex> outside{outside_, std::defer_lock};
+  if (workers_.empty()) {
+    outside.lock();
+  } else if (!outside.try_lock()) {
+    Task task;
+    task.run = [&fn] { fn(); };
+    {
+      std::lock_guard<std::mutex> lock{injected_.mutex};
+      injected_.tasks.push_back(&task);
+    }
+    pending_.fetch_add(1);
+    {
+      std::lock_guard<std::mutex> lock{sleep_mutex_};
+      wake_.notify_one();
+    }
+    Wait(task);
+    if (task.error) {
+      std::rethrow_exception(task.error);
+    }
+    return;
+  }
+
+  auto saved = Current();
+  Current() = {this, 0};
+  try {
+    fn();
+  } catch (...) {
+    Current() = saved;
+    throw;
+  }
+  Current() = saved;
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_EXECUTOR_H_
@@ -0,0 +1,149 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The executor is tested through the guarantees the algorithms rely on rather than its
+  scheduling decisions, which depend on timing.
+
+  * ParallelFor
+    - every index in the range is visited exactly once, for several grains
+    - slots stay below Size() and no slot is ever used by two pieces at the same time
+    - a single slow piece doesn't stop the other participants from finishing the rest
+    - nested ParallelFor calls and calls from several outside threads at once
+    - an executor of size 1 runs everything on the calling thread
+  * Join
+    - recursive fork-join computes the right answer
+    - an exception from either side is rethrown once both sides have finished
+
+*/
+
+#include "assignments/dg/executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.h"
+
+namespace {
+
+std::size_t Fib(gdwg::Executor& executor, std::size_t n) {
+  if (n < 2) {
+    return n;
+  }
+  std::size_t a = 0;
+  std::size_t b = 0;
+  executor.Join([&] { a = Fib(executor, n - 1); }, [&] { b = Fib(executor, n - 2); });
+  return a + b;
+}
+
+}  // namespace
+
+SCENARIO("Parallel loops over a range") {
+  GIVEN("An executor with several threads") {
+    gdwg::Executor executor{4};
+    REQUIRE(executor.Size() == 4);
+    THEN("Every index is visited once whatever the grain") {
+      for (std::size_t grain : {0, 1, 7, 1000}) {
+        std::vector<std::atomic<int>> visits(5000);
+        executor.ParallelFor(0, visits.size(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+          for (auto i = lo; i < hi; ++i) {
+            visits[i].fetch_add(1);
+          }
+        }, grain);
+        std::size_t wrong = 0;
+        for (const auto& v : visits) {
+          wrong += v.load() != 1;
+        }
+        REQUIRE(wrong == 0);
+      }
+    }
+    THEN("A slot is never used by two pieces at once") {
+      std::vector<std::atomic<bool>> busy(executor.Size());
+      std::atomic<bool> clash{false};
+      std::atomic<bool> out_of_range{false};
+      executor.ParallelFor(0, 2000, [&](std::size_t, std::size_t, std::size_t slot) {
+        if (slot >= busy.size()) {
+          out_of_range = true;
+          return;
+        }
+        if (busy[slot].exchange(true)) {
+          clash = true;
+        }
+        std::this_thread::yield();
+        busy[slot] = false;
+      }, 1);
+      REQUIRE_FALSE(out_of_range);
+      REQUIRE_FALSE(clash);
+    }
+    THEN("One slow piece doesn't hold up the rest") {
+      // The first piece only finishes once the others have, or gives up after a while
+      std::atomic<std::size_t> others{0};
+      std::size_t seen_by_slow = 0;
+      executor.ParallelFor(0, 1000, [&](std::size_t lo, std::size_t, std::size_t) {
+        if (lo != 0) {
+          others.fetch_add(1);
+          return;
+        }
+        auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while (others.load() < 999 && std::chrono::steady_clock::now() < give_up) {
+          std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        seen_by_slow = others.load();
+      }, 1);
+      REQUIRE(seen_by_slow == 999);
+    }
+    THEN("Loops can nest and be started from several threads at once") {
+      std::atomic<std::size_t> total{0};
+      auto work = [&] {
+        executor.ParallelFor(0, 50, [&](std::size_t lo, std::size_t hi, std::size_t) {
+          for (auto i = lo; i < hi; ++i) {
+            executor.ParallelFor(0, 100, [&](std::size_t l, std::size_t h, std::size_t) {
+              total.fetch_add(h - l);
+            });
+          }
+        });
+      };
+      std::vector<std::thread> callers;
+      for (int i = 0; i < 3; ++i) {
+        callers.emplace_back(work);
+      }
+      for (auto& caller : callers) {
+        caller.join();
+      }
+      REQUIRE(total.load() == 3 * 50 * 100);
+    }
+  }
+  GIVEN("An executor of size 1") {
+    gdwg::Executor executor{1};
+    THEN("Everything runs on the calling thread") {
+      std::set<std::thread::id> ids;
+      executor.ParallelFor(0, 100, [&](std::size_t, std::size_t, std::size_t slot) {
+        REQUIRE(slot == 0);
+        ids.insert(std::this_thread::get_id());
+      }, 1);
+      REQUIRE(ids == std::set<std::thread::id>{std::this_thread::get_id()});
+    }
+  }
+}
+
+SCENARIO("Fork-join") {
+  GIVEN("An executor") {
+    gdwg::Executor executor{4};
+    THEN("Recursive joins give the right answer") { REQUIRE(Fib(executor, 22) == 17711); }
+    THEN("Exceptions from either side are rethrown after both finish") {
+      std::atomic<bool> other_finished{false};
+      auto slow = [&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        other_finished = true;
+      };
+      REQUIRE_THROWS_WITH(executor.Join([] { throw std::runtime_error{"left"}; }, slow), "left");
+      REQUIRE(other_finished);
+      REQUIRE_THROWS_WITH(executor.Join([] {}, [] { throw std::runtime_error{"right"}; }),
+                          "right");
+    }
+  }
+}
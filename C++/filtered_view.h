@@ -0,0 +1,167 @@
+#ifndef ASSIGNMENTS_DG_FILTERED_VIEW_H_
+#define ASSIGNMENTS_DG_FILTERED_VIEW_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Edge predicate that keeps every edge
+struct KeepAllEdges {
+  template <typename N, typename E>
+  bool operator()(const N& /* src */, const N& /* dst */, const E& /* w */) const noexcept {
+    return true;
+  }
+};
+
+// Read-only view of the part of a Graph that passes two predicates, without copying it.
+// A node is in the view if node_pred(node) holds, and an edge if both its ends are and
+// edge_pred(src, dst, weight) holds. The predicates are called as the view is walked, so the
+// view always reflects the graph's current contents; it must not outlive the graph.
+//
+// Iteration is in node order, with each node's edges in the order the graph holds them.
+// Unlike Graph's own iterator the view never sorts or cleans up edge lists, so it can be
+// walked from several threads at once. To run the algorithms on a view, build a PackedGraph
+// from it.
+template <typename N, typename E, typename NodePred, typename EdgePred = KeepAllEdges>
+class FilteredView {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    reference operator*() const { return {*node_->first, *dst_, edge_->second}; }
+
+    const_iterator& operator++() {
+      ++edge_;
+      Settle();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.node_ == rhs.node_ && (lhs.node_ == lhs.end_ || lhs.edge_ == rhs.edge_);
+    }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    using NodeIt = typename gdwg::Graph<N, E>::NodeMap::const_iterator;
+    using EdgeIt = typename gdwg::Graph<N, E>::EdgeList::const_iterator;
+
+    friend class FilteredView;
+    const_iterator(const FilteredView* view, NodeIt node, NodeIt end)
+      : view_{view}, node_{node}, end_{end} {
+      Enter();
+      Settle();
+    }
+
+    // Skips nodes outside the view and starts on the first edge of the one found
+    void Enter() {
+      while (node_ != end_ && !view_->node_pred_(*node_->first)) {
+        ++node_;
+      }
+      if (node_ != end_) {
+        edge_ = node_->second->edges_.cbegin();
+      }
+    }
+
+    // Moves forward to the next edge in the view, if edge_ isn't one
+    void Settle() {
+      while (node_ != end_) {
+        if (edge_ == node_->second->edges_.cend()) {
+          ++node_;
+          Enter();
+          continue;
+        }
+        auto dst = edge_->first.lock();
+        if (dst && view_->node_pred_(*dst) &&
+            view_->edge_pred_(*node_->first, *dst, edge_->second)) {
+          // Held so the dst stays alive while the iterator points at it
+          dst_ = std::move(dst);
+          return;
+        }
+        ++edge_;
+      }
+      dst_.reset();
+    }
+
+    const FilteredView* view_ = nullptr;
+    NodeIt node_;
+    NodeIt end_;
+    EdgeIt edge_;
+    std::shared_ptr<N> dst_;
+  };
+
+  FilteredView(const gdwg::Graph<N, E>& g, NodePred node_pred, EdgePred edge_pred = {})
+    : g_{g}, node_pred_{std::move(node_pred)}, edge_pred_{std::move(edge_pred)} {}
+
+  const_iterator cbegin() const {
+    return const_iterator{this, g_.nodes_.cbegin(), g_.nodes_.cend()};
+  }
+  const_iterator cend() const {
+    return const_iterator{this, g_.nodes_.cend(), g_.nodes_.cend()};
+  }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+
+  bool IsNode(const N& val) const {
+    return g_.nodes_.find(g_.Key(val)) != g_.nodes_.end() && node_pred_(val);
+  }
+
+  // Calls fn(node) for each node in the view, in order
+  template <typename Fn>
+  void ForEachNode(const Fn& fn) const {
+    for (const auto& node : g_.nodes_) {
+      if (node_pred_(*node.first)) {
+        fn(*node.first);
+      }
+    }
+  }
+
+  std::vector<N> GetNodes() const {
+    std::vector<N> nodes;
+    ForEachNode([&nodes](const N& node) { nodes.push_back(node); });
+    return nodes;
+  }
+
+  // Both walk the view, so O(V) and O(V + E)
+  std::size_t NumNodes() const {
+    std::size_t count = 0;
+    ForEachNode([&count](const N&) { ++count; });
+    return count;
+  }
+  std::size_t NumEdges() const {
+    return static_cast<std::size_t>(std::distance(cbegin(), cend()));
+  }
+
+  const gdwg::Graph<N, E>& Source() const noexcept { return g_; }
+  const NodePred& NodePredicate() const noexcept { return node_pred_; }
+  const EdgePred& EdgePredicate() const noexcept { return edge_pred_; }
+
+ private:
+  const gdwg::Graph<N, E>& g_;
+  NodePred node_pred_;
+  EdgePred edge_pred_;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_FILTERED_VIEW_H_
@@ -0,0 +1,131 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  A view is checked against the graph it stands for: the induced subgraph of the same nodes,
+  with the same edges filtered out by hand. That graph is what a caller would otherwise have
+  built, so the view must iterate, count and pack exactly like it.
+  * Iteration
+    - only edges with both ends in the view and passing the edge predicate are visited
+    - a node predicate alone keeps every edge between kept nodes
+    - views of an empty graph, and views that keep nothing, are empty
+    - edges to deleted nodes are skipped, and the view follows later changes to the graph
+  * Queries
+    - IsNode, GetNodes, NumNodes and NumEdges agree with the equivalent graph
+  * Algorithms
+    - a PackedGraph built from a view matches one built from the equivalent graph, and
+      BFS on it only walks the view
+
+*/
+
+#include "assignments/dg/filtered_view.h"
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/algorithms.h"
+#include "assignments/dg/executor.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/packed_graph.h"
+#include "catch.h"
+
+namespace {
+
+using Edges = std::vector<std::tuple<std::string, std::string, int>>;
+
+template <typename View>
+Edges Collect(const View& view) {
+  Edges edges;
+  for (const auto& [src, dst, w] : view) {
+    edges.emplace_back(src, dst, w);
+  }
+  std::sort(edges.begin(), edges.end());
+  return edges;
+}
+
+}  // namespace
+
+SCENARIO("Filtered views of a graph") {
+  GIVEN("A graph split between two tenants, named by their first letter") {
+    gdwg::Graph<std::string, int> g{"a1", "a2", "a3", "b1", "b2"};
+    g.InsertEdge("a1", "a2", 1);
+    g.InsertEdge("a1", "a2", 7);
+    g.InsertEdge("a2", "a3", 2);
+    g.InsertEdge("a3", "a1", 8);
+    g.InsertEdge("a1", "b1", 3);
+    g.InsertEdge("b1", "a3", 4);
+    g.InsertEdge("b1", "b2", 5);
+    auto tenant_a = [](const std::string& node) { return node[0] == 'a'; };
+
+    WHEN("Viewing tenant a") {
+      gdwg::FilteredView view{g, tenant_a};
+      THEN("It holds the same as tenant a's induced subgraph") {
+        auto sub = g.InducedSubgraph({"a1", "a2", "a3"});
+        REQUIRE(Collect(view) == Edges(sub.cbegin(), sub.cend()));
+        REQUIRE(view.GetNodes() == sub.GetNodes());
+        REQUIRE(view.NumNodes() == 3);
+        REQUIRE(view.NumEdges() == sub.NumEdges());
+        REQUIRE(view.IsNode("a2"));
+        REQUIRE_FALSE(view.IsNode("b1"));
+        REQUIRE_FALSE(view.IsNode("zz"));
+      }
+    }
+
+    WHEN("Edges are filtered too") {
+      gdwg::FilteredView light{g, tenant_a, [](const std::string&, const std::string&, int w) {
+                                 return w < 5;
+                               }};
+      THEN("Only light edges between a nodes are left") {
+        REQUIRE(Collect(light) == Edges{{"a1", "a2", 1}, {"a2", "a3", 2}});
+        REQUIRE(light.NumNodes() == 3);
+      }
+    }
+
+    WHEN("The graph changes after the view is made") {
+      gdwg::FilteredView view{g, tenant_a};
+      g.DeleteNode("a3");
+      g.InsertNode("a4");
+      g.InsertEdge("a4", "a1", 9);
+      THEN("The view shows the change without touching the graph's edge lists") {
+        REQUIRE(Collect(view) == Edges{{"a1", "a2", 1}, {"a1", "a2", 7}, {"a4", "a1", 9}});
+        REQUIRE(view.GetNodes() == std::vector<std::string>{"a1", "a2", "a4"});
+      }
+    }
+
+    WHEN("Nothing passes") {
+      gdwg::FilteredView none{g, [](const std::string&) { return false; }};
+      THEN("The view is empty") {
+        REQUIRE(none.begin() == none.end());
+        REQUIRE(none.NumNodes() == 0);
+      }
+    }
+
+    WHEN("A view is packed and searched") {
+      gdwg::FilteredView view{g, tenant_a};
+      gdwg::PackedGraph<std::string, int> packed{view};
+      auto sub = g.InducedSubgraph({"a1", "a2", "a3"});
+      gdwg::PackedGraph<std::string, int> expected{sub};
+      gdwg::Executor pool{2};
+      auto bfs = gdwg::BFS(packed, std::string{"a1"}, pool);
+      THEN("It packs like the induced subgraph and BFS stays inside it") {
+        REQUIRE(packed.Nodes() == expected.Nodes());
+        REQUIRE(packed.Offsets() == expected.Offsets());
+        REQUIRE(packed.Targets() == expected.Targets());
+        REQUIRE(packed.Weights() == expected.Weights());
+        REQUIRE(bfs.nodes == std::vector<std::string>{"a1", "a2", "a3"});
+        REQUIRE(bfs.distance == std::vector<std::size_t>{0, 1, 2});
+      }
+    }
+  }
+
+  GIVEN("An empty graph") {
+    gdwg::Graph<int, int> g;
+    gdwg::FilteredView view{g, [](int) { return true; }};
+    THEN("Its view is empty") {
+      REQUIRE(view.begin() == view.end());
+      REQUIRE(view.NumEdges() == 0);
+    }
+  }
+}
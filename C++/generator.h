@@ -0,0 +1,144 @@
+#ifndef ASSIGNMENTS_DG_GENERATOR_H_
+#define ASSIGNMENTS_DG_GENERATOR_H_
+
+// Coroutines need C++20. In earlier modes this header is empty and the lazy Graph queries
+// built on it are left out.
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace gdwg {
+
+// Lazily produced sequence of T, written as a coroutine that co_yields each element.
+// Nothing runs until the first element is asked for and the coroutine stays suspended
+// between elements, so a caller that stops early never pays for the rest. T may be a
+// reference or a tuple of references; yielded values are only valid until the next one is
+// asked for.
+template <typename T>
+class Generator {
+ public:
+  using value_type = std::remove_cv_t<std::remove_reference_t<T>>;
+  using reference = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+  using pointer = std::add_pointer_t<reference>;
+
+  class promise_type {
+   public:
+    Generator get_return_object() noexcept {
+      return Generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_always final_suspend() const noexcept { return {}; }
+
+    // The yielded object outlives the suspension, so only its address is kept
+    std::suspend_always yield_value(std::remove_reference_t<T>& value) noexcept {
+      value_ = std::addressof(value);
+      return {};
+    }
+    std::suspend_always yield_value(std::remove_reference_t<T>&& value) noexcept {
+      value_ = std::addressof(value);
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { error_ = std::current_exception(); }
+    // Generators can't co_await anything else
+    template <typename U>
+    std::suspend_never await_transform(U&&) = delete;
+
+    reference Value() const noexcept { return static_cast<reference>(*value_); }
+    void Rethrow() const {
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+    }
+
+   private:
+    pointer value_ = nullptr;
+    std::exception_ptr error_;
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  struct Sentinel {};
+
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename Generator::value_type;
+    using reference = typename Generator::reference;
+    using pointer = typename Generator::pointer;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+
+    reference operator*() const { return handle_.promise().Value(); }
+
+    Iterator& operator++() {
+      handle_.resume();
+      if (handle_.done()) {
+        handle_.promise().Rethrow();
+      }
+      return *this;
+    }
+    void operator++(int) { ++(*this); }
+
+    friend bool operator==(const Iterator& it, Sentinel) noexcept {
+      return !it.handle_ || it.handle_.done();
+    }
+    friend bool operator!=(const Iterator& it, Sentinel s) noexcept { return !(it == s); }
+    friend bool operator==(Sentinel s, const Iterator& it) noexcept { return it == s; }
+    friend bool operator!=(Sentinel s, const Iterator& it) noexcept { return !(it == s); }
+
+   private:
+    friend class Generator;
+    explicit Iterator(Handle handle) noexcept : handle_{handle} {}
+
+    Handle handle_;
+  };
+
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+  Generator(Generator&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+  Generator& operator=(Generator&& other) noexcept {
+    if (this != &other) {
+      if (handle_) {
+        handle_.destroy();
+      }
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Generator() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  // Starts the coroutine, so it may only be called once
+  Iterator begin() {
+    if (handle_) {
+      handle_.resume();
+      if (handle_.done()) {
+        handle_.promise().Rethrow();
+      }
+    }
+    return Iterator{handle_};
+  }
+  Sentinel end() const noexcept { return {}; }
+
+ private:
+  explicit Generator(Handle handle) noexcept : handle_{handle} {}
+
+  Handle handle_;
+};
+
+}  // namespace gdwg
+
+#endif  // defined(__cpp_impl_coroutine)
+
+#endif  // ASSIGNMENTS_DG_GENERATOR_H_
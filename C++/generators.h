@@ -0,0 +1,313 @@
+#ifndef ASSIGNMENTS_DG_GENERATORS_H_
+#define ASSIGNMENTS_DG_GENERATORS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/executor.h"
+
+namespace gdwg {
+namespace generators {
+
+// Synthetic graph generators for load testing.
+// A generator describes a graph of NumEdges() (src, dst) edges between node ids in
+// [0, NumNodes()). The edges are split into chunks of kChunkEdges, and a chunk's edges only
+// depend on the seed and the chunk index. Chunks can therefore be produced in any order or in
+// parallel and the same seed always gives the same graph, whatever the number of threads.
+// Nothing is materialised unless asked for, so generators can describe graphs far larger
+// than memory and be streamed.
+
+constexpr std::size_t kChunkEdges = std::size_t{1} << 16;
+
+namespace detail {
+
+// SplitMix64 finaliser: a cheap bijective hash with good avalanche
+inline std::uint64_t Mix(std::uint64_t x) noexcept {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// SplitMix64 stream, one per chunk
+class Random {
+ public:
+  explicit Random(std::uint64_t seed) noexcept : state_{seed} {}
+
+  std::uint64_t Next() noexcept { return Mix(state_++); }
+  // The modulo bias is below 2^-32 for any bound that fits in 32 bits
+  std::uint64_t Below(std::uint64_t bound) noexcept { return Next() % bound; }
+  double Unit() noexcept { return static_cast<double>(Next() >> 11) * 0x1.0p-53; }
+
+ private:
+  std::uint64_t state_;
+};
+
+inline std::uint64_t ChunkSeed(std::uint64_t seed, std::size_t chunk) noexcept {
+  return Mix(seed ^ Mix(chunk));
+}
+
+inline std::size_t NumChunks(std::size_t edges) noexcept {
+  return (edges + kChunkEdges - 1) / kChunkEdges;
+}
+
+inline std::pair<std::size_t, std::size_t> ChunkRange(std::size_t edges, std::size_t chunk) {
+  return {chunk * kChunkEdges, std::min(edges, (chunk + 1) * kChunkEdges)};
+}
+
+}  // namespace detail
+
+// G(n, m): m edges with both endpoints drawn uniformly, with replacement, so self loops and
+// repeated pairs can occur
+class ErdosRenyi {
+ public:
+  ErdosRenyi(std::size_t nodes, std::size_t edges, std::uint64_t seed)
+    : nodes_{nodes}, edges_{edges}, seed_{seed} {
+    if (nodes == 0 && edges > 0) {
+      throw std::invalid_argument{
+          "Cannot construct generators::ErdosRenyi with edges but no nodes"};
+    }
+  }
+
+  std::size_t NumNodes() const noexcept { return nodes_; }
+  std::size_t NumEdges() const noexcept { return edges_; }
+  std::size_t NumChunks() const noexcept { return detail::NumChunks(edges_); }
+
+  template <typename Sink>
+  void Generate(std::size_t chunk, Sink&& sink) const {
+    auto [begin, end] = detail::ChunkRange(edges_, chunk);
+    detail::Random rng{detail::ChunkSeed(seed_, chunk)};
+    for (auto e = begin; e < end; ++e) {
+      auto src = rng.Below(nodes_);
+      sink(static_cast<std::size_t>(src), static_cast<std::size_t>(rng.Below(nodes_)));
+    }
+  }
+
+ private:
+  std::size_t nodes_;
+  std::size_t edges_;
+  std::uint64_t seed_;
+};
+
+// R-MAT, the stochastic Kronecker graph with a 2x2 initiator: 2^scale nodes and
+// edge_factor * 2^scale edges, each placed by recursively picking a quadrant of the adjacency
+// matrix with probabilities a, b, c and 1 - a - b - c. The defaults are Graph500's. Low ids
+// become hubs; scramble permutes the ids so the hubs are spread out.
+class Rmat {
+ public:
+  Rmat(std::size_t scale,
+       std::size_t edge_factor,
+       std::uint64_t seed,
+       double a = 0.57,
+       double b = 0.19,
+       double c = 0.19,
+       bool scramble = true)
+    : scale_{scale}, edges_{scale < 64 ? edge_factor << scale : 0}, seed_{seed}, a_{a},
+      ab_{a + b}, abc_{a + b + c}, scramble_{scramble} {
+    if (scale >= 64) {
+      throw std::invalid_argument{"Cannot construct generators::Rmat with a scale of 64 or more"};
+    }
+    if (a < 0 || b < 0 || c < 0 || abc_ > 1) {
+      throw std::invalid_argument{
+          "Cannot construct generators::Rmat unless a, b and c are probabilities summing to at "
+          "most 1"};
+    }
+    // Odd multipliers make the scramble a bijection on [0, 2^scale)
+    multiplier_[0] = detail::Mix(seed ^ 0x5ca1ab1eULL) | 1U;
+    multiplier_[1] = detail::Mix(seed ^ 0xdecafbadULL) | 1U;
+  }
+
+  std::size_t NumNodes() const noexcept { return std::size_t{1} << scale_; }
+  std::size_t NumEdges() const noexcept { return edges_; }
+  std::size_t NumChunks() const noexcept { return detail::NumChunks(edges_); }
+
+  template <typename Sink>
+  void Generate(std::size_t chunk, Sink&& sink) const {
+    auto [begin, end] = detail::ChunkRange(edges_, chunk);
+    detail::Random rng{detail::ChunkSeed(seed_, chunk)};
+    for (auto e = begin; e < end; ++e) {
+      std::uint64_t src = 0;
+      std::uint64_t dst = 0;
+      for (std::size_t level = 0; level < scale_; ++level) {
+        auto u = rng.Unit();
+        src = (src << 1) | (u >= ab_ ? 1U : 0U);
+        dst = (dst << 1) | ((u >= a_ && u < ab_) || u >= abc_ ? 1U : 0U);
+      }
+      sink(Scramble(src), Scramble(dst));
+    }
+  }
+
+ private:
+  std::size_t Scramble(std::uint64_t id) const noexcept {
+    if (!scramble_ || scale_ == 0) {
+      return static_cast<std::size_t>(id);
+    }
+    auto mask = (std::uint64_t{1} << scale_) - 1;
+    auto shift = scale_ / 2 + 1;
+    for (auto multiplier : multiplier_) {
+      id = (id * multiplier) & mask;
+      id ^= id >> shift;
+    }
+    return static_cast<std::size_t>(id);
+  }
+
+  std::size_t scale_;
+  std::size_t edges_;
+  std::uint64_t seed_;
+  double a_;
+  double ab_;
+  double abc_;
+  bool scramble_;
+  std::uint64_t multiplier_[2];
+};
+
+// Barabási–Albert preferential attachment: node v adds edges_per_node edges to earlier nodes,
+// picked with probability proportional to their degree so far. Follows Batagelj and Brandes'
+// edge-copying formulation, where edge e's target is a uniformly chosen endpoint of the edges
+// before it. The choice is a hash of the seed and e, so each target is resolved on its own
+// by following earlier edges back until it lands on a source (Sanders and Schulz), which keeps
+// chunks independent.
+class BarabasiAlbert {
+ public:
+  BarabasiAlbert(std::size_t nodes, std::size_t edges_per_node, std::uint64_t seed)
+    : nodes_{nodes}, per_node_{edges_per_node}, seed_{seed} {
+    if (edges_per_node == 0) {
+      throw std::invalid_argument{
+          "Cannot construct generators::BarabasiAlbert with zero edges per node"};
+    }
+  }
+
+  std::size_t NumNodes() const noexcept { return nodes_; }
+  std::size_t NumEdges() const noexcept { return nodes_ * per_node_; }
+  std::size_t NumChunks() const noexcept { return detail::NumChunks(NumEdges()); }
+
+  template <typename Sink>
+  void Generate(std::size_t chunk, Sink&& sink) const {
+    auto [begin, end] = detail::ChunkRange(NumEdges(), chunk);
+    for (auto e = begin; e < end; ++e) {
+      sink(e / per_node_, Target(e));
+    }
+  }
+
+ private:
+  // Endpoint slots run src(0), dst(0), src(1), dst(1), ... and edge e picks one of the first
+  // 2e + 1, so it can pick its own source but never a later edge
+  std::size_t Target(std::size_t e) const noexcept {
+    while (true) {
+      auto slot = detail::Mix(seed_ ^ detail::Mix(e)) % (2 * e + 1);
+      if (slot % 2 == 0) {
+        return (slot / 2) / per_node_;
+      }
+      e = slot / 2;
+    }
+  }
+
+  std::size_t nodes_;
+  std::size_t per_node_;
+  std::uint64_t seed_;
+};
+
+// rows x cols lattice where node r * cols + c links to its right and lower neighbours, and
+// back again when bidirectional. Deterministic, so there is no seed.
+class Grid {
+ public:
+  Grid(std::size_t rows, std::size_t cols, bool bidirectional = true)
+    : rows_{rows}, cols_{cols}, bidirectional_{bidirectional},
+      across_{cols == 0 ? 0 : rows * (cols - 1)}, down_{rows == 0 ? 0 : (rows - 1) * cols} {}
+
+  std::size_t NumNodes() const noexcept { return rows_ * cols_; }
+  std::size_t NumEdges() const noexcept { return (across_ + down_) * (bidirectional_ ? 2 : 1); }
+  std::size_t NumChunks() const noexcept { return detail::NumChunks(NumEdges()); }
+
+  template <typename Sink>
+  void Generate(std::size_t chunk, Sink&& sink) const {
+    auto [begin, end] = detail::ChunkRange(NumEdges(), chunk);
+    auto forward = across_ + down_;
+    for (auto e = begin; e < end; ++e) {
+      auto base = e < forward ? e : e - forward;
+      std::size_t src;
+      std::size_t dst;
+      if (base < across_) {
+        src = (base / (cols_ - 1)) * cols_ + base % (cols_ - 1);
+        dst = src + 1;
+      } else {
+        src = base - across_;
+        dst = src + cols_;
+      }
+      if (e < forward) {
+        sink(src, dst);
+      } else {
+        sink(dst, src);
+      }
+    }
+  }
+
+ private:
+  std::size_t rows_;
+  std::size_t cols_;
+  bool bidirectional_;
+  std::size_t across_;
+  std::size_t down_;
+};
+
+// Calls sink(src, dst) for every edge, in chunk order
+template <typename Generator, typename Sink>
+void Stream(const Generator& gen, Sink&& sink) {
+  for (std::size_t chunk = 0; chunk < gen.NumChunks(); ++chunk) {
+    gen.Generate(chunk, sink);
+  }
+}
+
+// Calls sink(src, dst, slot) for every edge from the executor's threads. Calls with different
+// slots can run concurrently (see Executor::ParallelFor), so the sink should keep per-slot
+// state; the order across chunks is unspecified.
+template <typename Generator, typename Sink>
+void ParallelStream(const Generator& gen, gdwg::Executor& pool, Sink&& sink) {
+  pool.ParallelFor(0, gen.NumChunks(), [&](std::size_t lo, std::size_t hi, std::size_t slot) {
+    for (auto chunk = lo; chunk < hi; ++chunk) {
+      gen.Generate(chunk, [&](std::size_t src, std::size_t dst) { sink(src, dst, slot); });
+    }
+  }, 1);
+}
+
+// Bulk path: every edge in the same order Stream produces them. Each chunk's position is known
+// up front, so the threads write straight into the result.
+template <typename Generator>
+std::vector<std::pair<std::size_t, std::size_t>> GenerateEdges(const Generator& gen,
+                                                               gdwg::Executor& pool) {
+  std::vector<std::pair<std::size_t, std::size_t>> edges(gen.NumEdges());
+  pool.ParallelFor(0, gen.NumChunks(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+    for (auto chunk = lo; chunk < hi; ++chunk) {
+      auto* out = edges.data() + chunk * kChunkEdges;
+      gen.Generate(chunk, [&out](std::size_t src, std::size_t dst) { *out++ = {src, dst}; });
+    }
+  }, 1);
+  return edges;
+}
+
+// Streams a generated graph into g: node id i becomes node(i) and each edge is inserted with
+// weight(src_id, dst_id). Edges that repeat an existing (src, dst, weight) are skipped, as
+// InsertEdge does.
+template <typename N, typename E, typename Generator, typename NodeFn, typename WeightFn>
+void Fill(gdwg::Graph<N, E>& g, const Generator& gen, const NodeFn& node, const WeightFn& weight) {
+  g.Reserve(gen.NumNodes(), gen.NumEdges());
+  std::vector<N> values;
+  values.reserve(gen.NumNodes());
+  for (std::size_t id = 0; id < gen.NumNodes(); ++id) {
+    values.push_back(node(id));
+    g.InsertNode(values.back());
+  }
+  Stream(gen, [&](std::size_t src, std::size_t dst) {
+    g.InsertEdge(values[src], values[dst], weight(src, dst));
+  });
+}
+
+}  // namespace generators
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_GENERATORS_H_
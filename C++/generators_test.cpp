@@ -0,0 +1,170 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Every generator is checked for the properties callers rely on: the advertised node and
+  edge counts, endpoints in range, and determinism. Determinism is tested both ways round:
+  the same seed gives the same edges however many threads produce them, and a different
+  seed gives a different graph. The shape of each generator is then checked loosely, since
+  the exact edges depend on the hash.
+
+  * All generators
+    - NumEdges edges, all endpoints below NumNodes
+    - GenerateEdges on one or several threads matches Stream exactly
+    - ParallelStream visits the same multiset of edges
+  * Grid
+    - exact edge set, including the single-row and single-column edge cases
+  * Rmat
+    - unscrambled, the lowest id is the biggest hub
+    - bad probabilities throw
+  * BarabasiAlbert
+    - every edge points back to an earlier (or the same) node
+    - degrees are heavy tailed
+  * Fill
+    - streams a generated graph into a Graph with caller-chosen node values and weights
+
+*/
+
+#include "assignments/dg/generators.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/executor.h"
+#include "catch.h"
+
+namespace {
+
+using EdgeList = std::vector<std::pair<std::size_t, std::size_t>>;
+
+template <typename Generator>
+EdgeList Collect(const Generator& gen) {
+  EdgeList edges;
+  gdwg::generators::Stream(gen, [&](std::size_t src, std::size_t dst) {
+    edges.emplace_back(src, dst);
+  });
+  return edges;
+}
+
+template <typename Generator>
+void CheckGenerator(const Generator& gen) {
+  auto edges = Collect(gen);
+  REQUIRE(edges.size() == gen.NumEdges());
+  auto out_of_range = std::count_if(edges.begin(), edges.end(), [&](const auto& e) {
+    return e.first >= gen.NumNodes() || e.second >= gen.NumNodes();
+  });
+  REQUIRE(out_of_range == 0);
+  for (std::size_t threads : {1, 4}) {
+    gdwg::Executor pool{threads};
+    REQUIRE(gdwg::generators::GenerateEdges(gen, pool) == edges);
+  }
+
+  gdwg::Executor pool{4};
+  std::mutex mutex;
+  EdgeList streamed;
+  gdwg::generators::ParallelStream(gen, pool, [&](std::size_t src, std::size_t dst, std::size_t) {
+    std::lock_guard<std::mutex> lock{mutex};
+    streamed.emplace_back(src, dst);
+  });
+  std::sort(streamed.begin(), streamed.end());
+  std::sort(edges.begin(), edges.end());
+  REQUIRE(streamed == edges);
+}
+
+}  // namespace
+
+SCENARIO("Generators are deterministic and in range") {
+  GIVEN("One generator of each kind, spanning several chunks") {
+    gdwg::generators::ErdosRenyi er{1000, 3 * gdwg::generators::kChunkEdges + 17, 7};
+    gdwg::generators::Rmat rmat{12, 40, 7};
+    gdwg::generators::BarabasiAlbert ba{50000, 4, 7};
+    gdwg::generators::Grid grid{300, 400};
+    THEN("Each produces NumEdges in-range edges, the same on any number of threads") {
+      CheckGenerator(er);
+      CheckGenerator(rmat);
+      CheckGenerator(ba);
+      CheckGenerator(grid);
+    }
+    THEN("A different seed gives a different graph") {
+      REQUIRE(Collect(er) != Collect(gdwg::generators::ErdosRenyi{1000, er.NumEdges(), 8}));
+      REQUIRE(Collect(rmat) != Collect(gdwg::generators::Rmat{12, 40, 8}));
+      REQUIRE(Collect(ba) != Collect(gdwg::generators::BarabasiAlbert{50000, 4, 8}));
+    }
+  }
+}
+
+SCENARIO("Grid graphs") {
+  GIVEN("A 2x3 grid") {
+    gdwg::generators::Grid one_way{2, 3, false};
+    gdwg::generators::Grid both_ways{2, 3};
+    THEN("Each node links right and down") {
+      auto edges = Collect(one_way);
+      std::sort(edges.begin(), edges.end());
+      REQUIRE(edges == EdgeList{{0, 1}, {0, 3}, {1, 2}, {1, 4}, {2, 5}, {3, 4}, {4, 5}});
+      REQUIRE(both_ways.NumEdges() == 14);
+      auto reversed = Collect(both_ways);
+      auto back = std::make_pair(std::size_t{5}, std::size_t{4});
+      REQUIRE(std::count(reversed.begin(), reversed.end(), back) == 1);
+    }
+  }
+  GIVEN("Degenerate grids") {
+    THEN("A single row or column is a path and a single cell has no edges") {
+      REQUIRE(Collect(gdwg::generators::Grid{1, 4, false}) == EdgeList{{0, 1}, {1, 2}, {2, 3}});
+      REQUIRE(Collect(gdwg::generators::Grid{3, 1, false}) == EdgeList{{0, 1}, {1, 2}});
+      REQUIRE(Collect(gdwg::generators::Grid{1, 1}).empty());
+      REQUIRE(Collect(gdwg::generators::Grid{0, 5}).empty());
+    }
+  }
+}
+
+SCENARIO("Skewed generators") {
+  GIVEN("An unscrambled R-MAT graph") {
+    gdwg::generators::Rmat rmat{10, 16, 3, 0.57, 0.19, 0.19, false};
+    std::vector<std::size_t> degree(rmat.NumNodes());
+    gdwg::generators::Stream(rmat, [&](std::size_t src, std::size_t) { ++degree[src]; });
+    THEN("Node 0 is the biggest hub") {
+      REQUIRE(std::max_element(degree.begin(), degree.end()) == degree.begin());
+      REQUIRE(degree[0] > 20 * 16);
+    }
+    THEN("Probabilities that don't add up throw") {
+      REQUIRE_THROWS_WITH((gdwg::generators::Rmat{10, 16, 3, 0.6, 0.3, 0.3}),
+                          "Cannot construct generators::Rmat unless a, b and c are probabilities "
+                          "summing to at most 1");
+    }
+  }
+  GIVEN("A Barabási–Albert graph") {
+    gdwg::generators::BarabasiAlbert ba{20000, 3, 11};
+    std::vector<std::size_t> in_degree(ba.NumNodes());
+    bool backwards = true;
+    gdwg::generators::Stream(ba, [&](std::size_t src, std::size_t dst) {
+      backwards = backwards && dst <= src;
+      ++in_degree[dst];
+    });
+    THEN("Edges only point at earlier nodes") { REQUIRE(backwards); }
+    THEN("A few early nodes collect far more than the average degree") {
+      REQUIRE(*std::max_element(in_degree.begin(), in_degree.end()) > 100 * 3);
+    }
+  }
+}
+
+SCENARIO("Filling a Graph from a generator") {
+  GIVEN("A small grid") {
+    gdwg::generators::Grid grid{3, 3};
+    gdwg::Graph<std::string, int> g;
+    gdwg::generators::Fill(
+        g, grid, [](std::size_t id) { return "n" + std::to_string(id); },
+        [](std::size_t src, std::size_t dst) { return static_cast<int>(src * 10 + dst); });
+    THEN("Every node and edge is inserted") {
+      REQUIRE(g.size() == 9);
+      REQUIRE(g.NumEdges() == grid.NumEdges());
+      REQUIRE(g.IsConnected("n4", "n5"));
+      REQUIRE(g.IsConnected("n5", "n4"));
+      REQUIRE(g.GetWeights("n1", "n4") == std::vector<int>{14});
+      REQUIRE_FALSE(g.IsConnected("n0", "n4"));
+    }
+  }
+}
@@ -2,6 +2,9 @@
 #define ASSIGNMENTS_DG_GRAPH_H_
 
 #include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <list>
@@ -10,12 +13,128 @@
 #include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#include "assignments/dg/generator.h"
+#include "assignments/dg/journal.h"
+
 namespace gdwg {
 
+template <typename N, typename E>
+class PackedGraph;
+template <typename N, typename E, typename NodePred, typename EdgePred>
+class FilteredView;
+
+// Heap bytes owned by a node or edge value on top of sizeof(T), used by Graph::MemoryUsage.
+// Types that allocate can either specialise this or provide a `std::size_t HeapUsage() const`.
+template <typename T, typename = void>
+struct HeapUsage {
+  std::size_t operator()(const T&) const noexcept { return 0; }
+};
+
+template <typename T>
+struct HeapUsage<T, std::void_t<decltype(std::declval<const T&>().HeapUsage())>> {
+  std::size_t operator()(const T& val) const { return val.HeapUsage(); }
+};
+
+template <typename C, typename T, typename A>
+struct HeapUsage<std::basic_string<C, T, A>, void> {
+  std::size_t operator()(const std::basic_string<C, T, A>& val) const noexcept {
+    // Short strings live inside the object
+    auto data = reinterpret_cast<const char*>(val.data());
+    auto self = reinterpret_cast<const char*>(&val);
+    if (data >= self && data < self + sizeof(val)) {
+      return 0;
+    }
+    return (val.capacity() + 1) * sizeof(C);
+  }
+};
+
+// Counts of the hidden work done on Graph's hot paths. They are only collected when built
+// with GDWG_GRAPH_STATS defined; otherwise the counting compiles away and Stats() is all zeros.
+struct GraphStats {
+  // Node map searches
+  std::size_t index_lookups = 0;
+  // Probe keys built to search the node map, plus list cells of edge lists copied by reads
+  std::size_t temporary_allocations = 0;
+  // Edge list sorts done while iterating or printing
+  std::size_t lazy_sorts = 0;
+  // Edges to deleted nodes removed by iteration, printing and degree queries
+  std::size_t read_cleanups = 0;
+  // InsertEdge duplicate checks, and how many edges they looked at
+  std::size_t duplicate_checks = 0;
+  std::size_t duplicate_scan_length = 0;
+  std::size_t longest_duplicate_scan = 0;
+};
+
+// Estimated bytes held by a Graph. Node-based containers are costed using the usual
+// libstdc++/libc++ node layouts; allocator rounding is not included.
+struct GraphMemory {
+  // The Graph object, the ordered node map and the per-node records
+  std::size_t node_index = 0;
+  std::size_t node_values = 0;
+  // std::list cells, each holding a weak_ptr to the dst, excluding the weight itself
+  std::size_t edge_cells = 0;
+  std::size_t control_blocks = 0;
+  std::size_t weights = 0;
+  // The topological order and weight index, when enabled
+  std::size_t indexes = 0;
+
+  std::size_t Total() const noexcept {
+    return node_index + node_values + edge_cells + control_blocks + weights + indexes;
+  }
+};
+
+// One change to a Graph, as delivered to subscribers. Events are raised after the change has
+// been made and only for changes that took effect. A deleted node takes its edges with it,
+// and a merge moves old_value's edges to new_value, without separate edge events. sequence
+// counts the graph's changes from 1, with no gaps, whether or not anyone is subscribed.
+template <typename N, typename E>
+struct GraphChange {
+  struct NodeInserted {
+    N node;
+  };
+  struct EdgeInserted {
+    N src;
+    N dst;
+    E weight;
+  };
+  struct EdgeErased {
+    N src;
+    N dst;
+    E weight;
+  };
+  struct NodeDeleted {
+    N node;
+  };
+  struct NodeReplaced {
+    N old_value;
+    N new_value;
+  };
+  struct NodesMerged {
+    N old_value;
+    N new_value;
+  };
+  struct Cleared {};
+
+  // In JournalOp order
+  using Event = std::variant<NodeInserted,
+                             EdgeInserted,
+                             EdgeErased,
+                             NodeDeleted,
+                             NodeReplaced,
+                             NodesMerged,
+                             Cleared>;
+
+  std::uint64_t sequence;
+  Event event;
+};
+
 template <typename N, typename E>
 class Graph {
  private:
@@ -48,10 +167,29 @@ class Graph {
     }
   };
 
+  struct Node;
+
+  // A node's place in the topological order and the nodes with edges into it
+  struct OrderState {
+    std::size_t ord_ = 0;
+    std::vector<Node*> in_;
+  };
+
+  // A node's out-edges by weight
+  using WeightIndex = std::multimap<E, std::weak_ptr<N>>;
+
   struct Node {
     explicit Node(std::shared_ptr<N> value) : value_(value) {}
     std::shared_ptr<N> value_;
     mutable std::list<std::pair<std::weak_ptr<N>, E>> edges_;
+    // Live edges pointing at this node, including self loops
+    std::size_t in_degree_ = 0;
+    // Live edges out of this node; edges_ may also hold edges to deleted nodes
+    std::size_t out_degree_ = 0;
+    // Only allocated while a topological order is maintained
+    std::unique_ptr<OrderState> topo_;
+    // Only allocated while the weight index is enabled
+    std::unique_ptr<WeightIndex> by_weight_;
   };
 
   struct NodeCompare {
@@ -60,6 +198,10 @@ class Graph {
     }
   };
 
+  using NodeMap = std::map<std::shared_ptr<N>, std::shared_ptr<Node>, NodeCompare>;
+  using EdgeList = std::list<std::pair<std::weak_ptr<N>, E>>;
+  using Position = std::pair<typename NodeMap::const_iterator, typename EdgeList::const_iterator>;
+
  public:
   class Iterator {
    public:
@@ -96,17 +238,91 @@ class Graph {
     typename std::map<std::shared_ptr<N>, std::shared_ptr<Node>, NodeCompare>::const_iterator
         curr_node_;
     typename std::list<std::pair<std::weak_ptr<N>, E>>::const_iterator edge_it_;
+    // Edges to deleted nodes cleaned up while iterating are counted against the graph
+    const Graph* graph_;
 
     friend class Graph;
     explicit Iterator(const decltype(it_end_)& it_e,
                       const decltype(curr_node_)& curr_node,
-                      const decltype(edge_it_)& edge_it)
-      : it_end_{it_e}, curr_node_{curr_node}, edge_it_{edge_it} {}
+                      const decltype(edge_it_)& edge_it,
+                      const Graph* graph)
+      : it_end_{it_e}, curr_node_{curr_node}, edge_it_{edge_it}, graph_{graph} {}
   };
 
   using const_reverse_iterator = std::reverse_iterator<Iterator>;
   using const_iterator = Iterator;
 
+  // A slice of the edges that can be walked at the same time as other slices, from other
+  // threads. Unlike Iterator it never sorts or cleans up: nodes come in order but each node's
+  // edges come in whatever order its list is in, and edges to deleted nodes are skipped over.
+  // Any change to the graph, or walking it with Iterator, invalidates the range.
+  class EdgeRange {
+   public:
+    class Iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::tuple<N, N, E>;
+      using reference = std::tuple<const N&, const N&, const E&>;
+      using pointer = void;
+      using difference_type = std::ptrdiff_t;
+
+      reference operator*() const {
+        return {*at_.first->first, *at_.second->first.lock(), at_.second->second};
+      }
+
+      Iterator& operator++() {
+        ++at_.second;
+        Settle();
+        return *this;
+      }
+      Iterator operator++(int) {
+        auto copy{*this};
+        ++(*this);
+        return copy;
+      }
+
+      friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.At(rhs.at_); }
+      friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return !(lhs == rhs); }
+
+     private:
+      friend class EdgeRange;
+      Iterator(const Position& at, const Position& stop, typename NodeMap::const_iterator map_end)
+        : at_{at}, stop_{stop}, map_end_{map_end} {}
+
+      bool At(const Position& pos) const {
+        return at_.first == pos.first && (at_.first == map_end_ || at_.second == pos.second);
+      }
+      void Settle();
+
+      Position at_;
+      Position stop_;
+      typename NodeMap::const_iterator map_end_;
+    };
+
+    Iterator begin() const {
+      Iterator it{first_, last_, map_end_};
+      it.Settle();
+      return it;
+    }
+    Iterator end() const { return Iterator{last_, last_, map_end_}; }
+
+    // Edge cells in the range, including edges to deleted nodes that are skipped over
+    std::size_t size() const noexcept { return size_; }
+
+   private:
+    friend class Graph;
+    EdgeRange(const Position& first,
+              const Position& last,
+              typename NodeMap::const_iterator map_end,
+              std::size_t size)
+      : first_{first}, last_{last}, map_end_{map_end}, size_{size} {}
+
+    Position first_;
+    Position last_;
+    typename NodeMap::const_iterator map_end_;
+    std::size_t size_;
+  };
+
   // CONSTRUCTORS
   Graph() = default;
   Graph(typename std::vector<N>::const_iterator begin,
@@ -138,6 +354,98 @@ class Graph {
   bool erase(const N& src, const N& dst, const E& w) noexcept;
   const_iterator erase(const_iterator it) noexcept;
 
+  // Inserts every edge that isn't already in the graph and returns how many were added.
+  // Edges are grouped by src so each src is looked up once and its existing edges are checked
+  // against the whole group in one pass, instead of one scan per edge as InsertEdge does.
+  // Input already sorted by (src, dst, weight) is not sorted again. Throws, before changing
+  // anything, if an endpoint doesn't exist.
+  std::size_t InsertEdges(std::vector<std::tuple<N, N, E>> edges);
+
+  // A new graph of just these nodes and the edges between them, built in one pass over their
+  // edge lists rather than by copying the whole graph and deleting the rest. nodes may be in
+  // any order and repeat. The topological order and weight index are enabled on the result
+  // if they are on here. Throws if a node doesn't exist.
+  gdwg::Graph<N, E> InducedSubgraph(const std::vector<N>& nodes) const;
+
+  // Keeps a topological order up to date as edges are added (Pearce-Kelly). While enabled,
+  // InsertEdge and MergeReplace throw instead of creating a cycle.
+  void EnableTopologicalOrder();
+  void DisableTopologicalOrder() noexcept;
+  bool MaintainsTopologicalOrder() const noexcept { return ordered_; }
+  std::vector<N> TopologicalOrder() const;
+
+  // Splits the edges into k ranges of nearly equal edge count, splitting inside a node's edges
+  // when needed so a hub doesn't unbalance them. Together the ranges cover every edge once.
+  std::vector<EdgeRange> EdgeRanges(std::size_t k) const;
+
+#if defined(__cpp_impl_coroutine)
+  // Lazy views of the edges as (src, dst, weight), for callers that may stop early. Like
+  // EdgeRange they neither sort nor clean up: nodes come in order, each node's edges in list
+  // order, and edges to deleted nodes are skipped. The graph must not change while one is
+  // being consumed.
+  gdwg::Generator<std::tuple<const N&, const N&, const E&>> Edges() const;
+  gdwg::Generator<std::tuple<const N&, const N&, const E&>> OutEdges(const N& src) const;
+#endif
+
+  // Counters kept up to date by every mutation
+  std::size_t size() const noexcept { return nodes_.size(); }
+  bool empty() const noexcept { return nodes_.empty(); }
+  std::size_t NumEdges() const noexcept { return num_edges_; }
+  // Number of out-edges (not distinct neighbours), not counting edges to deleted nodes. O(1),
+  // and never cleans anything up, so concurrent readers are safe.
+  std::size_t OutDegree(const N& src) const;
+  // Out-degree -> number of nodes with that out-degree
+  std::map<std::size_t, std::size_t> DegreeHistogram() const;
+  // Capacity hint. The map and edge lists are node-based and cannot reserve, so this only
+  // pre-sizes the vector-backed side structures.
+  void Reserve(std::size_t nodes, std::size_t edges);
+
+  // Cheapest-first out-edge queries, returned as (dst, weight) sorted by weight then dst.
+  // They scan and partially sort unless the per-node weight index is enabled.
+  std::vector<std::pair<N, E>> TopKEdges(const N& src, std::size_t k);
+  std::vector<std::pair<N, E>> EdgesInWeightRange(const N& src, const E& lo, const E& hi);
+  std::optional<E> MinWeight(const N& src, const N& dst);
+  std::optional<E> MaxWeight(const N& src, const N& dst);
+  void EnableWeightIndex();
+  void DisableWeightIndex() noexcept;
+  bool HasWeightIndex() const noexcept { return weight_index_; }
+
+  // Changes on every successful mutation and never repeats for this object, so derived
+  // indexes can tell when they are stale
+  std::size_t Version() const noexcept { return version_; }
+
+  // Appends every successful mutation to journal until replaced or detached with nullptr.
+  // The journal must outlive the attachment, and copies of the graph don't share it.
+  void SetJournal(gdwg::Journal* journal) noexcept {
+    static_assert(kEncodable, "Specialise gdwg::Codec for the node and edge types to journal them");
+    journal_ = journal;
+  }
+  // Writes every node and edge, and whether the topological order and weight index are on,
+  // for Recover to read. Start a new journal log after taking one.
+  void Snapshot(std::ostream& out) const;
+  // Replaces the graph with snapshot, then replays the journal log written after it up to
+  // the first torn or corrupt group, and returns how many records were replayed. Nothing is
+  // journaled while recovering. Throws, leaving the graph as it was, if the snapshot is
+  // malformed or the log doesn't apply to it.
+  std::size_t Recover(std::istream& snapshot, std::istream& log);
+
+  // Calls callback with every later change, synchronously and in order, and returns an id
+  // for Unsubscribe. Callbacks must not throw, change the graph, or (un)subscribe. Copies of
+  // the graph don't inherit subscriptions. See also ChangeCursor.
+  std::size_t Subscribe(std::function<void(const gdwg::GraphChange<N, E>&)> callback);
+  // Returns false if id isn't subscribed
+  bool Unsubscribe(std::size_t id) noexcept;
+  // Sequence number of the latest change, 0 before the first
+  std::uint64_t Sequence() const noexcept { return sequence_; }
+
+  // Walks every node and edge, so O(V + E). Edges to deleted nodes that have not been
+  // cleaned up yet still take up memory and are included.
+  gdwg::GraphMemory MemoryUsage() const;
+
+  // Snapshot of the hot-path counters, see GraphStats
+  gdwg::GraphStats Stats() const noexcept;
+  void ResetStats() noexcept;
+
   // ITERATORS
   const_iterator cbegin() const;
   const_iterator cend() const;
@@ -168,11 +476,14 @@ class Graph {
   friend std::ostream& operator<<(std::ostream& os, const gdwg::Graph<N, E>& g) {
     for (auto node : g.nodes_) {
       os << *node.first << " (\n";
+      g.Count(&GraphStats::lazy_sorts);
       node.second->edges_.sort(Edge::edgeComparator);
       for (auto edge = node.second->edges_.cbegin(); edge != node.second->edges_.cend();) {
         // Clean up edge if it contains dst node that no longer exists
         if (edge->first.expired()) {
           edge = node.second->edges_.erase(edge);
+          --g.tombstones_;
+          g.Count(&GraphStats::read_cleanups);
         } else {
           os << "  " << *edge->first.lock() << " | " << edge->second << "\n";
           edge++;
@@ -186,8 +497,155 @@ class Graph {
   // Debugging
   void PrintGraph();
 
+  friend class PackedGraph<N, E>;
+  template <typename M, typename F, typename NodePred, typename EdgePred>
+  friend class FilteredView;
+
  private:
   std::map<std::shared_ptr<N>, std::shared_ptr<Node>, NodeCompare> nodes_;
+
+  // Topological order maintenance
+  Node* NodeOf(const std::shared_ptr<N>& val) const {
+    Count(&GraphStats::index_lookups);
+    return nodes_.find(val)->second.get();
+  }
+  void RebuildOrder();
+  bool ReorderForEdge(Node* src, Node* dst);
+  bool Reaches(Node* from, Node* to) const;
+  void DropInEdge(Node* src, Node* dst);
+
+  bool ordered_ = false;
+  std::vector<Node*> order_;
+
+  // Weight index maintenance
+  void RebuildWeightIndex();
+  void DropFromWeightIndex(Node* src, const std::shared_ptr<N>& dst, const E& w);
+  template <typename Compare>
+  std::optional<E> ExtremeWeight(const N& src, const N& dst, Compare better, const char* what);
+
+  bool weight_index_ = false;
+
+#if defined(__cpp_impl_coroutine)
+  // Lazy traversal
+  static gdwg::Generator<std::tuple<const N&, const N&, const E&>> EdgesOf(const Node* node);
+  static gdwg::Generator<std::pair<const N&, std::size_t>> BreadthFirst(const Graph& g,
+                                                                        const Node* src);
+
+  template <typename M, typename F>
+  friend gdwg::Generator<std::pair<const M&, std::size_t>> BfsOrder(const gdwg::Graph<M, F>& g,
+                                                                    const M& src);
+#endif
+
+  struct Induced {};
+  Graph(Induced, const Graph& g, std::vector<N> nodes);
+
+  // Edge counting
+  void Recount();
+  std::size_t Purge(Node* node) const;
+
+  std::size_t num_edges_ = 0;
+  // Edges to deleted nodes that are still sitting in some edge list
+  mutable std::size_t tombstones_ = 0;
+
+  std::size_t version_ = 0;
+
+  // Persistence and change feed, which share one path: every change goes through Emit
+  static constexpr bool kEncodable = IsEncodable<N>::value && IsEncodable<E>::value;
+
+  template <JournalOp Op, typename... Fields>
+  void Emit(const Fields&... fields) {
+    if (muted_) {
+      return;
+    }
+    ++sequence_;
+    if constexpr (kEncodable) {
+      if (journal_ != nullptr) {
+        journal_->Record(Op, fields...);
+      }
+    }
+    if (!subscribers_.empty()) {
+      using Event = typename GraphChange<N, E>::Event;
+      using Alternative = std::variant_alternative_t<static_cast<std::size_t>(Op) - 1, Event>;
+      const GraphChange<N, E> change{sequence_, Event{Alternative{fields...}}};
+      for (const auto& subscriber : subscribers_) {
+        subscriber.second(change);
+      }
+    }
+  }
+  void EmitContents();
+
+  // Silences Emit while an operation made of other recorded operations runs, so only the
+  // operation itself is recorded
+  class Quiet {
+   public:
+    explicit Quiet(Graph& g) noexcept : g_{g}, muted_{std::exchange(g.muted_, true)} {}
+    Quiet(const Quiet&) = delete;
+    Quiet& operator=(const Quiet&) = delete;
+    ~Quiet() { Release(); }
+    void Release() noexcept { g_.muted_ = muted_; }
+
+   private:
+    Graph& g_;
+    bool muted_;
+  };
+
+  gdwg::Journal* journal_ = nullptr;
+  std::vector<std::pair<std::size_t, std::function<void(const GraphChange<N, E>&)>>>
+      subscribers_;
+  std::size_t next_subscriber_ = 0;
+  std::uint64_t sequence_ = 0;
+  bool muted_ = false;
+
+  // Instrumentation
+  std::shared_ptr<N> Key(const N& val) const {
+    Count(&GraphStats::temporary_allocations);
+    return std::make_shared<N>(val);
+  }
+  void Count(std::size_t GraphStats::*counter, std::size_t n = 1) const noexcept;
+  void RecordDuplicateScan(std::size_t scanned) const noexcept;
+
+#ifdef GDWG_GRAPH_STATS
+  mutable GraphStats stats_;
+#endif
+};
+
+#if defined(__cpp_impl_coroutine)
+// Nodes reachable from src as (node, hops from src), in breadth-first order. Each node's
+// out-edges are only looked at once the search gets to it, so stopping after the first few
+// nodes costs about as much as visiting them.
+template <typename N, typename E>
+gdwg::Generator<std::pair<const N&, std::size_t>> BfsOrder(const gdwg::Graph<N, E>& g,
+                                                            const N& src);
+#endif
+
+// Pull-based view of a graph's change feed: changes made while it exists queue up until
+// taken, so a consumer can catch up in its own time. Must not outlive the graph.
+template <typename N, typename E>
+class ChangeCursor {
+ public:
+  explicit ChangeCursor(gdwg::Graph<N, E>& g)
+    : g_{g}, id_{g.Subscribe([this](const GraphChange<N, E>& change) {
+        pending_.push_back(change);
+      })} {}
+  ChangeCursor(const ChangeCursor&) = delete;
+  ChangeCursor& operator=(const ChangeCursor&) = delete;
+  ~ChangeCursor() { g_.Unsubscribe(id_); }
+
+  // The oldest change not yet taken, if any
+  std::optional<GraphChange<N, E>> Next() {
+    if (pending_.empty()) {
+      return std::nullopt;
+    }
+    auto change = std::move(pending_.front());
+    pending_.pop_front();
+    return change;
+  }
+  std::size_t Pending() const noexcept { return pending_.size(); }
+
+ private:
+  gdwg::Graph<N, E>& g_;
+  std::deque<GraphChange<N, E>> pending_;
+  std::size_t id_;
 };
 
 }  // namespace gdwg
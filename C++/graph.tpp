@@ -1,6 +1,12 @@
 #include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -50,6 +56,12 @@ gdwg::Graph<N, E>::Graph(const typename gdwg::Graph<N, E>& g) noexcept {
   for (auto node = g.nodes_.cbegin(); node != g.nodes_.cend(); node++) {
     this->InsertNode(*node->first);
   }
+  if (g.ordered_) {
+    this->EnableTopologicalOrder();
+  }
+  if (g.weight_index_) {
+    this->EnableWeightIndex();
+  }
   for (auto it = g.cbegin(); it != g.cend(); it++) {
     this->InsertEdge(std::get<0>(*it), std::get<1>(*it), std::get<2>(*it));
   }
@@ -57,7 +69,60 @@ gdwg::Graph<N, E>::Graph(const typename gdwg::Graph<N, E>& g) noexcept {
 
 // Move Constructor
 template <typename N, typename E>
-gdwg::Graph<N, E>::Graph(typename gdwg::Graph<N, E>&& g) noexcept : nodes_{std::move(g.nodes_)} {}
+gdwg::Graph<N, E>::Graph(typename gdwg::Graph<N, E>&& g) noexcept
+  : nodes_{std::move(g.nodes_)}, ordered_{g.ordered_}, order_{std::move(g.order_)},
+    weight_index_{g.weight_index_}, num_edges_{g.num_edges_}, tombstones_{g.tombstones_} {
+  g.ordered_ = false;
+  g.order_.clear();
+  g.weight_index_ = false;
+  g.num_edges_ = 0;
+  g.tombstones_ = 0;
+  ++g.version_;
+}
+
+// Induced subgraph: each kept node is copied once, and edge targets are translated by the
+// address of the original node value instead of being looked up again
+template <typename N, typename E>
+gdwg::Graph<N, E>::Graph(Induced, const gdwg::Graph<N, E>& g, std::vector<N> nodes) {
+  std::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  std::unordered_map<const N*, Node*> kept;
+  kept.reserve(nodes.size());
+  std::vector<std::pair<const Node*, Node*>> copies;
+  copies.reserve(nodes.size());
+  for (const auto& val : nodes) {
+    g.Count(&GraphStats::index_lookups);
+    auto found = g.nodes_.find(g.Key(val));
+    if (found == g.nodes_.end()) {
+      throw std::out_of_range{
+          "Cannot call Graph::InducedSubgraph with a node that doesn't exist in the graph"};
+    }
+    auto value = std::make_shared<N>(*found->first);
+    auto node = std::make_shared<Node>(value);
+    kept.emplace(found->first.get(), node.get());
+    copies.emplace_back(found->second.get(), node.get());
+    // nodes is sorted, so every insert goes at the end
+    nodes_.emplace_hint(nodes_.end(), std::move(value), std::move(node));
+  }
+  for (const auto& [from, to] : copies) {
+    for (const auto& e : from->edges_) {
+      auto dst = e.first.lock();
+      auto target = dst ? kept.find(dst.get()) : kept.end();
+      if (target != kept.end()) {
+        to->edges_.emplace_back(target->second->value_, e.second);
+        ++target->second->in_degree_;
+        ++to->out_degree_;
+        ++num_edges_;
+      }
+    }
+  }
+  if (g.ordered_) {
+    EnableTopologicalOrder();
+  }
+  if (g.weight_index_) {
+    EnableWeightIndex();
+  }
+}
 
 ////////////////
 // OPERATIONS //
@@ -74,6 +139,19 @@ gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(const gdwg::Graph<N, E>& g) noex
 template <typename N, typename E>
 gdwg::Graph<N, E>& gdwg::Graph<N, E>::operator=(gdwg::Graph<N, E>&& g) noexcept {
   this->nodes_ = std::move(g.nodes_);
+  this->ordered_ = g.ordered_;
+  this->order_ = std::move(g.order_);
+  g.ordered_ = false;
+  g.order_.clear();
+  this->weight_index_ = g.weight_index_;
+  g.weight_index_ = false;
+  this->num_edges_ = g.num_edges_;
+  this->tombstones_ = g.tombstones_;
+  g.num_edges_ = 0;
+  g.tombstones_ = 0;
+  this->version_ = std::max(this->version_, g.version_) + 1;
+  ++g.version_;
+  EmitContents();
   return *this;
 }
 
@@ -85,7 +163,17 @@ template <typename N, typename E>
 bool gdwg::Graph<N, E>::InsertNode(const N& val) noexcept {
   if (!this->IsNode(val)) {
     auto node = std::make_shared<N>(val);
-    this->nodes_[node] = std::make_shared<Node>(node);
+    auto& inserted = this->nodes_[node] = std::make_shared<Node>(node);
+    if (ordered_) {
+      inserted->topo_ = std::make_unique<OrderState>();
+      inserted->topo_->ord_ = order_.size();
+      order_.push_back(inserted.get());
+    }
+    if (weight_index_) {
+      inserted->by_weight_ = std::make_unique<WeightIndex>();
+    }
+    ++version_;
+    Emit<JournalOp::kInsertNode>(val);
     return true;
   } else {
     return false;
@@ -99,23 +187,146 @@ bool gdwg::Graph<N, E>::InsertEdge(const N& src, const N& dst, const E& w) {
         "Cannot call Graph::InsertEdge when either src or dst node does not exist"};
   }
 
-  auto src_shared = std::make_shared<N>(src);
-  auto dst_shared = std::make_shared<N>(dst);
+  auto src_shared = Key(src);
+  auto dst_shared = Key(dst);
 
+  Count(&GraphStats::index_lookups);
   std::weak_ptr<N> d = nodes_.find(dst_shared)->first;
 
   // Check if edges already exists. Return false
+  Count(&GraphStats::index_lookups);
+  std::size_t scanned = 0;
   for (auto e : nodes_.find(src_shared)->second->edges_) {
-    if (*e.first.lock() == dst && e.second == w) {
+    ++scanned;
+    if (!e.first.expired() && *e.first.lock() == dst && e.second == w) {
+      RecordDuplicateScan(scanned);
       return false;
     }
   }
+  RecordDuplicateScan(scanned);
+
+  if (ordered_) {
+    Node* src_node = NodeOf(src_shared);
+    Node* dst_node = NodeOf(dst_shared);
+    if (!ReorderForEdge(src_node, dst_node)) {
+      throw std::runtime_error{"Cannot call Graph::InsertEdge when the edge would create a cycle"};
+    }
+    dst_node->topo_->in_.push_back(src_node);
+  }
 
   // Add outgoing edge from src node
+  Count(&GraphStats::index_lookups);
   nodes_.find(src_shared)->second->edges_.push_back(std::make_pair(d, w));
+  if (weight_index_) {
+    Count(&GraphStats::index_lookups);
+    nodes_.find(src_shared)->second->by_weight_->emplace(w, d);
+  }
+  ++NodeOf(dst_shared)->in_degree_;
+  ++NodeOf(src_shared)->out_degree_;
+  ++num_edges_;
+  ++version_;
+  Emit<JournalOp::kInsertEdge>(src, dst, w);
   return true;
 }
 
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::InsertEdges(std::vector<std::tuple<N, N, E>> edges) {
+  if (!std::is_sorted(edges.begin(), edges.end())) {
+    std::sort(edges.begin(), edges.end());
+  }
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // Resolve every endpoint before inserting anything
+  std::vector<std::pair<Node*, Node*>> ends;
+  ends.reserve(edges.size());
+  Node* src_node = nullptr;
+  Node* dst_node = nullptr;
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    const auto& [src, dst, w] = edges[i];
+    if (i == 0 || std::get<0>(edges[i - 1]) != src) {
+      Count(&GraphStats::index_lookups);
+      auto found = nodes_.find(Key(src));
+      src_node = found == nodes_.end() ? nullptr : found->second.get();
+    }
+    if (i == 0 || std::get<1>(edges[i - 1]) != dst) {
+      Count(&GraphStats::index_lookups);
+      auto found = nodes_.find(Key(dst));
+      dst_node = found == nodes_.end() ? nullptr : found->second.get();
+    }
+    if (src_node == nullptr || dst_node == nullptr) {
+      throw std::runtime_error{
+          "Cannot call Graph::InsertEdges when either src or dst node does not exist"};
+    }
+    ends.emplace_back(src_node, dst_node);
+  }
+
+  // Cycle checks need the edges one at a time
+  if (ordered_) {
+    std::size_t inserted = 0;
+    for (const auto& [src, dst, w] : edges) {
+      inserted += InsertEdge(src, dst, w);
+    }
+    return inserted;
+  }
+
+  std::size_t inserted = 0;
+  std::vector<bool> present;
+  for (std::size_t lo = 0, hi = 0; lo < edges.size(); lo = hi) {
+    Node* src = ends[lo].first;
+    while (hi < edges.size() && ends[hi].first == src) {
+      ++hi;
+    }
+    // The group is sorted by (dst, weight), so each existing edge is one binary search
+    present.assign(hi - lo, false);
+    auto first = edges.begin() + static_cast<std::ptrdiff_t>(lo);
+    auto last = edges.begin() + static_cast<std::ptrdiff_t>(hi);
+    std::size_t scanned = 0;
+    for (const auto& e : src->edges_) {
+      ++scanned;
+      auto dst = e.first.lock();
+      if (!dst) {
+        continue;
+      }
+      auto match = std::lower_bound(first, last, std::tie(*dst, e.second),
+                                    [](const auto& edge, const auto& key) {
+                                      return std::tie(std::get<1>(edge), std::get<2>(edge)) < key;
+                                    });
+      if (match != last && std::get<1>(*match) == *dst && std::get<2>(*match) == e.second) {
+        present[static_cast<std::size_t>(match - first)] = true;
+      }
+    }
+    RecordDuplicateScan(scanned);
+
+    for (std::size_t i = lo; i < hi; ++i) {
+      if (present[i - lo]) {
+        continue;
+      }
+      Node* dst = ends[i].second;
+      const auto& w = std::get<2>(edges[i]);
+      std::weak_ptr<N> d = dst->value_;
+      src->edges_.emplace_back(d, w);
+      if (weight_index_) {
+        src->by_weight_->emplace(w, d);
+      }
+      ++dst->in_degree_;
+      ++src->out_degree_;
+      ++num_edges_;
+      // Counters are committed before each event, so subscribers see them and a journal
+      // that throws leaves every linked edge counted
+      if (inserted++ == 0) {
+        ++version_;
+      }
+      Emit<JournalOp::kInsertEdge>(std::get<0>(edges[i]), std::get<1>(edges[i]), w);
+    }
+  }
+  return inserted;
+}
+
+template <typename N, typename E>
+gdwg::Graph<N, E> gdwg::Graph<N, E>::InducedSubgraph(const std::vector<N>& nodes) const {
+  return gdwg::Graph<N, E>{Induced{}, *this, nodes};
+}
+
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::DeleteNode(const N& val) noexcept {
   if (!this->IsNode(val)) {
@@ -123,11 +334,59 @@ bool gdwg::Graph<N, E>::DeleteNode(const N& val) noexcept {
   }
 
   try {
-    this->nodes_.erase(std::make_shared<N>(val));
+    Node* node = NodeOf(Key(val));
+    if (ordered_) {
+      for (const auto& e : node->edges_) {
+        if (auto dst = e.first.lock()) {
+          DropInEdge(node, NodeOf(dst));
+        }
+      }
+      order_.erase(order_.begin() + static_cast<std::ptrdiff_t>(node->topo_->ord_));
+      for (auto i = node->topo_->ord_; i < order_.size(); ++i) {
+        order_[i]->topo_->ord_ = i;
+      }
+    }
+    // Edges into the node are left behind as tombstones and cleaned up lazily
+    Purge(node);
+    std::size_t self_loops = 0;
+    for (const auto& e : node->edges_) {
+      Node* dst = NodeOf(e.first.lock());
+      if (dst == node) {
+        ++self_loops;
+      } else {
+        --dst->in_degree_;
+      }
+    }
+    // The edges stay behind, but stop counting towards their sources' out-degree now
+    auto incoming = node->in_degree_ - self_loops;
+    if (ordered_) {
+      for (Node* from : node->topo_->in_) {
+        --from->out_degree_;
+      }
+    } else {
+      auto left = incoming;
+      for (auto from = nodes_.begin(); from != nodes_.end() && left > 0; ++from) {
+        if (from->second.get() == node) {
+          continue;
+        }
+        for (const auto& e : from->second->edges_) {
+          if (e.first.lock() == node->value_) {
+            --from->second->out_degree_;
+            --left;
+          }
+        }
+      }
+    }
+    num_edges_ -= node->edges_.size() + incoming;
+    tombstones_ += incoming;
+    Count(&GraphStats::index_lookups);
+    this->nodes_.erase(Key(val));
   } catch (...) {
     return false;
   }
 
+  ++version_;
+  Emit<JournalOp::kDeleteNode>(val);
   return true;
 }
 
@@ -139,9 +398,12 @@ bool gdwg::Graph<N, E>::Replace(const N& oldData, const N& newData) {
   if (IsNode(newData)) {
     return false;
   }
-  auto oldDataPtr = std::make_shared<N>(oldData);
+  auto oldDataPtr = Key(oldData);
+  Count(&GraphStats::index_lookups);
   *(this->nodes_.find(oldDataPtr)->second->value_) = newData;
 
+  ++version_;
+  Emit<JournalOp::kReplace>(oldData, newData);
   return true;
 }
 
@@ -151,10 +413,26 @@ void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
     throw std::runtime_error{
         "Cannot call Graph::MergeReplace on old or new data if they don't exist in the graph"};
   }
+  // Merging a node into itself changes nothing
+  if (oldData == newData) {
+    return;
+  }
   // push back edges from oldData->edges to newData->edges
-  auto oldDataPtr = std::make_shared<N>(oldData);
-  auto newDataPtr = std::make_shared<N>(newData);
+  auto oldDataPtr = Key(oldData);
+  auto newDataPtr = Key(newData);
+  if (ordered_ && (Reaches(NodeOf(oldDataPtr), NodeOf(newDataPtr)) ||
+                   Reaches(NodeOf(newDataPtr), NodeOf(oldDataPtr)))) {
+    throw std::runtime_error{"Cannot call Graph::MergeReplace when merging would create a cycle"};
+  }
+  Quiet quiet{*this};
+  // Clean up the edges DeleteNode left behind first. Which of them reads have already cleaned
+  // up isn't journaled, and unique would take a live edge for a duplicate of an expired one.
+  for (auto& node : nodes_) {
+    Purge(node.second.get());
+  }
+  Count(&GraphStats::index_lookups);
   std::shared_ptr<Node> oldNode = nodes_.find(oldDataPtr)->second;
+  Count(&GraphStats::index_lookups);
   std::shared_ptr<Node> newNode = nodes_.find(newDataPtr)->second;
 
   // std::shared_ptr<N> oldNodeVal = oldNode->second->value;
@@ -167,6 +445,7 @@ void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
 
   for (auto n : this->nodes_) {
     auto edges = n.second->edges_;
+    Count(&GraphStats::temporary_allocations, edges.size());
     for (auto e = edges.begin(); e != edges.end();) {
       // clean up edges containing deleted nodes
       if ((*e).first.expired()) {
@@ -188,16 +467,33 @@ void gdwg::Graph<N, E>::MergeReplace(const N& oldData, const N& newData) {
   }
 
   DeleteNode(oldData);
+  oldNode.reset();
+  Recount();
+  ++version_;
+  if (ordered_) {
+    RebuildOrder();
+  }
+  if (weight_index_) {
+    RebuildWeightIndex();
+  }
+  quiet.Release();
+  Emit<JournalOp::kMergeReplace>(oldData, newData);
 }
 
 template <typename N, typename E>
 void gdwg::Graph<N, E>::Clear() noexcept {
   nodes_.clear();
+  order_.clear();
+  num_edges_ = 0;
+  tombstones_ = 0;
+  ++version_;
+  Emit<JournalOp::kClear>();
 }
 
 template <typename N, typename E>
 bool gdwg::Graph<N, E>::IsNode(const N& val) noexcept {
-  if (this->nodes_.count(std::make_shared<N>(val)) > 0) {
+  Count(&GraphStats::index_lookups);
+  if (this->nodes_.count(Key(val)) > 0) {
     return true;
   } else {
     return false;
@@ -210,7 +506,9 @@ bool gdwg::Graph<N, E>::IsConnected(const N& src, const N& dst) {
     throw std::runtime_error{
         "Cannot call Graph::IsConnected if src or dst node don't exist in the graph"};
   }
-  auto edges = nodes_.find(std::make_shared<N>(src))->second->edges_;
+  Count(&GraphStats::index_lookups);
+  auto edges = nodes_.find(Key(src))->second->edges_;
+  Count(&GraphStats::temporary_allocations, edges.size());
   for (auto e = edges.begin(); e != edges.end();) {
     // clean up edges containing deleted nodes
     if ((*e).first.expired()) {
@@ -243,11 +541,14 @@ std::vector<N> gdwg::Graph<N, E>::GetConnected(const N& src) {
     throw std::out_of_range{"Cannot call Graph::GetConnected if src doesn't exist in the graph"};
   }
   std::vector<N> vec;
-  auto edges = this->nodes_.find(std::make_shared<N>(src))->second->edges_;
+  Count(&GraphStats::index_lookups);
+  auto edges = this->nodes_.find(Key(src))->second->edges_;
+  Count(&GraphStats::temporary_allocations, edges.size());
 
   for (auto e = edges.cbegin(); e != edges.cend(); ++e) {
-    if (std::count(vec.begin(), vec.end(), *e->first.lock()) < 1) {
-      vec.push_back(*e->first.lock());
+    auto dst = e->first.lock();
+    if (dst && std::count(vec.begin(), vec.end(), *dst) < 1) {
+      vec.push_back(*dst);
     }
   }
   std::sort(vec.begin(), vec.end());
@@ -262,7 +563,9 @@ std::vector<E> gdwg::Graph<N, E>::GetWeights(const N& src, const N& dst) {
         "Cannot call Graph::GetWeights if src or dst node don't exist in the graph"};
   }
   std::vector<E> vec;
-  auto edges = this->nodes_.find(std::make_shared<N>(src))->second->edges_;
+  Count(&GraphStats::index_lookups);
+  auto edges = this->nodes_.find(Key(src))->second->edges_;
+  Count(&GraphStats::temporary_allocations, edges.size());
 
   for (auto e = edges.cbegin(); e != edges.cend(); ) {
     if ((*e).first.expired()) {
@@ -308,12 +611,25 @@ bool gdwg::Graph<N, E>::erase(const N& src, const N& dst, const E& w) noexcept {
   if (!IsNode(src) || !IsNode(dst)) {
     return false;
   }
-  auto src_node = nodes_.find(std::make_shared<N>(src));
+  Count(&GraphStats::index_lookups);
+  auto src_node = nodes_.find(Key(src));
   for (auto e = src_node->second->edges_.begin(); e != src_node->second->edges_.end();) {
     if ((*e).first.expired()) {
       e = src_node->second->edges_.erase(e);
+      --tombstones_;
     } else if (*e->first.lock() == dst && e->second == w) {
+      if (ordered_) {
+        DropInEdge(src_node->second.get(), NodeOf(e->first.lock()));
+      }
+      if (weight_index_) {
+        DropFromWeightIndex(src_node->second.get(), e->first.lock(), w);
+      }
+      --NodeOf(e->first.lock())->in_degree_;
+      --src_node->second->out_degree_;
+      --num_edges_;
       e = src_node->second->edges_.erase(e);
+      ++version_;
+      Emit<JournalOp::kErase>(src, dst, w);
       return true;
     } else {
       e++;
@@ -327,9 +643,21 @@ typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::erase(const_iterat
   if (it == cend()) {
     return cend();
   }
+  if (ordered_) {
+    DropInEdge(it.curr_node_->second.get(), NodeOf(it.edge_it_->first.lock()));
+  }
+  if (weight_index_) {
+    DropFromWeightIndex(it.curr_node_->second.get(), it.edge_it_->first.lock(),
+                        it.edge_it_->second);
+  }
+  --NodeOf(it.edge_it_->first.lock())->in_degree_;
+  --it.curr_node_->second->out_degree_;
+  --num_edges_;
+  Emit<JournalOp::kErase>(*it.curr_node_->first, *it.edge_it_->first.lock(), it.edge_it_->second);
   // auto curr_edge = it.edge_it_;
   // curr_edge++;
   it.edge_it_ = it.curr_node_->second->edges_.erase(it.edge_it_);
+  ++version_;
   // if at last edge of curr_node_
   if (it.edge_it_ == it.curr_node_->second->edges_.cend()) {
     // it.edge_it_ = it.curr_node_->second->edges.erase(it.edge_it_);
@@ -340,6 +668,820 @@ typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::erase(const_iterat
   return it;
 }
 
+template <typename N, typename E>
+void gdwg::Graph<N, E>::EnableTopologicalOrder() {
+  if (!ordered_) {
+    RebuildOrder();
+    ordered_ = true;
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::DisableTopologicalOrder() noexcept {
+  ordered_ = false;
+  order_.clear();
+  for (auto& node : nodes_) {
+    node.second->topo_.reset();
+  }
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::Graph<N, E>::TopologicalOrder() const {
+  if (!ordered_) {
+    throw std::runtime_error{
+        "Cannot call Graph::TopologicalOrder unless the topological order is maintained"};
+  }
+  std::vector<N> vec;
+  vec.reserve(order_.size());
+  for (auto node : order_) {
+    vec.push_back(*node->value_);
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+std::vector<std::pair<N, E>> gdwg::Graph<N, E>::TopKEdges(const N& src, std::size_t k) {
+  if (!IsNode(src)) {
+    throw std::out_of_range{"Cannot call Graph::TopKEdges if src doesn't exist in the graph"};
+  }
+  if (k == 0) {
+    return {};
+  }
+  auto by_cost = [](const std::pair<N, E>& a, const std::pair<N, E>& b) {
+    return a.second < b.second || (!(b.second < a.second) && a.first < b.first);
+  };
+  std::vector<std::pair<N, E>> vec;
+  Node* node = NodeOf(Key(src));
+  if (weight_index_) {
+    // Keep going past k while the weight ties with the last one taken, so ties break by dst
+    for (auto e = node->by_weight_->begin(); e != node->by_weight_->end();) {
+      auto dst = e->second.lock();
+      if (!dst) {
+        e = node->by_weight_->erase(e);
+        continue;
+      }
+      if (vec.size() >= k && vec.back().second < e->first) {
+        break;
+      }
+      vec.emplace_back(*dst, e->first);
+      ++e;
+    }
+    std::sort(vec.begin(), vec.end(), by_cost);
+  } else {
+    for (const auto& e : node->edges_) {
+      if (auto dst = e.first.lock()) {
+        vec.emplace_back(*dst, e.second);
+      }
+    }
+    auto middle = vec.begin() + static_cast<std::ptrdiff_t>(std::min(k, vec.size()));
+    std::partial_sort(vec.begin(), middle, vec.end(), by_cost);
+  }
+  if (vec.size() > k) {
+    vec.erase(vec.begin() + static_cast<std::ptrdiff_t>(k), vec.end());
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+std::vector<std::pair<N, E>>
+gdwg::Graph<N, E>::EdgesInWeightRange(const N& src, const E& lo, const E& hi) {
+  if (!IsNode(src)) {
+    throw std::out_of_range{
+        "Cannot call Graph::EdgesInWeightRange if src doesn't exist in the graph"};
+  }
+  std::vector<std::pair<N, E>> vec;
+  if (hi < lo) {
+    return vec;
+  }
+  Node* node = NodeOf(Key(src));
+  if (weight_index_) {
+    auto last = node->by_weight_->upper_bound(hi);
+    for (auto e = node->by_weight_->lower_bound(lo); e != last;) {
+      if (auto dst = e->second.lock()) {
+        vec.emplace_back(*dst, e->first);
+        ++e;
+      } else {
+        e = node->by_weight_->erase(e);
+      }
+    }
+  } else {
+    for (const auto& e : node->edges_) {
+      if (e.second < lo || hi < e.second) {
+        continue;
+      }
+      if (auto dst = e.first.lock()) {
+        vec.emplace_back(*dst, e.second);
+      }
+    }
+  }
+  std::sort(vec.begin(), vec.end(), [](const std::pair<N, E>& a, const std::pair<N, E>& b) {
+    return a.second < b.second || (!(b.second < a.second) && a.first < b.first);
+  });
+  return vec;
+}
+
+template <typename N, typename E>
+std::optional<E> gdwg::Graph<N, E>::MinWeight(const N& src, const N& dst) {
+  auto less = [](const E& a, const E& b) { return a < b; };
+  return ExtremeWeight(src, dst, less, "MinWeight");
+}
+
+template <typename N, typename E>
+std::optional<E> gdwg::Graph<N, E>::MaxWeight(const N& src, const N& dst) {
+  auto greater = [](const E& a, const E& b) { return b < a; };
+  return ExtremeWeight(src, dst, greater, "MaxWeight");
+}
+
+// One pass over src's edges without copying or sorting anything
+template <typename N, typename E>
+template <typename Compare>
+std::optional<E>
+gdwg::Graph<N, E>::ExtremeWeight(const N& src, const N& dst, Compare better, const char* what) {
+  if (!IsNode(src) || !IsNode(dst)) {
+    throw std::out_of_range{std::string{"Cannot call Graph::"} + what +
+                            " if src or dst node don't exist in the graph"};
+  }
+  std::optional<E> best;
+  for (const auto& e : NodeOf(Key(src))->edges_) {
+    auto target = e.first.lock();
+    if (target && *target == dst && (!best || better(e.second, *best))) {
+      best = e.second;
+    }
+  }
+  return best;
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::EnableWeightIndex() {
+  if (!weight_index_) {
+    weight_index_ = true;
+    RebuildWeightIndex();
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::DisableWeightIndex() noexcept {
+  weight_index_ = false;
+  for (auto& node : nodes_) {
+    node.second->by_weight_.reset();
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::RebuildWeightIndex() {
+  for (auto& node : nodes_) {
+    node.second->by_weight_ = std::make_unique<WeightIndex>();
+    for (const auto& e : node.second->edges_) {
+      if (!e.first.expired()) {
+        node.second->by_weight_->emplace(e.second, e.first);
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::DropFromWeightIndex(Node* src,
+                                            const std::shared_ptr<N>& dst,
+                                            const E& w) {
+  auto range = src->by_weight_->equal_range(w);
+  for (auto e = range.first; e != range.second; ++e) {
+    if (e->second.lock() == dst) {
+      src->by_weight_->erase(e);
+      return;
+    }
+  }
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::OutDegree(const N& src) const {
+  Count(&GraphStats::index_lookups);
+  auto node = nodes_.find(Key(src));
+  if (node == nodes_.end()) {
+    throw std::out_of_range{"Cannot call Graph::OutDegree if src doesn't exist in the graph"};
+  }
+  return node->second->out_degree_;
+}
+
+template <typename N, typename E>
+std::map<std::size_t, std::size_t> gdwg::Graph<N, E>::DegreeHistogram() const {
+  std::map<std::size_t, std::size_t> histogram;
+  for (const auto& node : nodes_) {
+    ++histogram[node.second->out_degree_];
+  }
+  return histogram;
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Reserve(std::size_t nodes, std::size_t /* edges */) {
+  if (ordered_) {
+    order_.reserve(nodes);
+  }
+}
+
+template <typename N, typename E>
+gdwg::GraphMemory gdwg::Graph<N, E>::MemoryUsage() const {
+  // Red-black tree nodes carry a colour and three links, list nodes two links, and a
+  // shared_ptr control block a vtable pointer and two counts
+  constexpr std::size_t kTreeNode = 4 * sizeof(void*);
+  constexpr std::size_t kListNode = 2 * sizeof(void*);
+  constexpr std::size_t kControlBlock = 2 * sizeof(void*);
+  using MapEntry = typename decltype(nodes_)::value_type;
+  using EdgeEntry = typename decltype(std::declval<Node>().edges_)::value_type;
+  using WeightEntry = typename WeightIndex::value_type;
+  gdwg::HeapUsage<N> node_heap;
+  gdwg::HeapUsage<E> weight_heap;
+
+  gdwg::GraphMemory usage;
+  usage.node_index = sizeof(*this) + nodes_.size() * (kTreeNode + sizeof(MapEntry) + sizeof(Node));
+  usage.control_blocks = nodes_.size() * 2 * kControlBlock;
+  usage.indexes = order_.capacity() * sizeof(Node*);
+  for (const auto& node : nodes_) {
+    usage.node_values += sizeof(N) + node_heap(*node.first);
+    usage.edge_cells += node.second->edges_.size() * (kListNode + sizeof(EdgeEntry) - sizeof(E));
+    for (const auto& e : node.second->edges_) {
+      usage.weights += sizeof(E) + weight_heap(e.second);
+    }
+    if (node.second->topo_) {
+      usage.indexes += sizeof(OrderState) + node.second->topo_->in_.capacity() * sizeof(Node*);
+    }
+    if (node.second->by_weight_) {
+      usage.indexes += sizeof(WeightIndex);
+      for (const auto& e : *node.second->by_weight_) {
+        usage.indexes += kTreeNode + sizeof(WeightEntry) + weight_heap(e.first);
+      }
+    }
+  }
+  return usage;
+}
+
+template <typename N, typename E>
+std::vector<typename gdwg::Graph<N, E>::EdgeRange>
+gdwg::Graph<N, E>::EdgeRanges(std::size_t k) const {
+  if (k == 0) {
+    throw std::runtime_error{"Cannot call Graph::EdgeRanges with zero ranges"};
+  }
+  // Moves a position at the end of a list on to the next edge, or to the end of the map
+  auto settle = [this](Position pos) {
+    while (pos.first != nodes_.cend() && pos.second == pos.first->second->edges_.cend()) {
+      if (++pos.first != nodes_.cend()) {
+        pos.second = pos.first->second->edges_.cbegin();
+      }
+    }
+    return pos;
+  };
+
+  std::size_t total = 0;
+  for (const auto& node : nodes_) {
+    total += node.second->edges_.size();
+  }
+  std::vector<Position> cuts;
+  cuts.reserve(k + 1);
+  if (nodes_.empty()) {
+    cuts.emplace_back(nodes_.cend(), typename EdgeList::const_iterator{});
+  } else {
+    cuts.push_back(settle({nodes_.cbegin(), nodes_.cbegin()->second->edges_.cbegin()}));
+  }
+  // Range i ends after floor(total * (i + 1) / k) edge cells
+  std::vector<std::size_t> targets{0};
+  targets.reserve(k + 1);
+  auto node = nodes_.cbegin();
+  std::size_t before = 0;
+  for (std::size_t i = 1; i <= k; ++i) {
+    auto target = total / k * i + total % k * i / k;
+    targets.push_back(target);
+    while (node != nodes_.cend() && before + node->second->edges_.size() <= target) {
+      before += node->second->edges_.size();
+      ++node;
+    }
+    if (node == nodes_.cend()) {
+      cuts.emplace_back(nodes_.cend(), typename EdgeList::const_iterator{});
+    } else {
+      auto offset = static_cast<std::ptrdiff_t>(target - before);
+      cuts.push_back(settle({node, std::next(node->second->edges_.cbegin(), offset)}));
+    }
+  }
+
+  std::vector<EdgeRange> ranges;
+  ranges.reserve(k);
+  for (std::size_t i = 0; i < k; ++i) {
+    ranges.push_back(EdgeRange{cuts[i], cuts[i + 1], nodes_.cend(), targets[i + 1] - targets[i]});
+  }
+  return ranges;
+}
+
+#if defined(__cpp_impl_coroutine)
+
+template <typename N, typename E>
+gdwg::Generator<std::tuple<const N&, const N&, const E&>> gdwg::Graph<N, E>::Edges() const {
+  // Walks the lists directly rather than through OutEdges, so there is one coroutine in all
+  // instead of one per node
+  for (const auto& node : nodes_) {
+    for (const auto& e : node.second->edges_) {
+      if (auto dst = e.first.lock()) {
+        co_yield std::tuple<const N&, const N&, const E&>{*node.first, *dst, e.second};
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+gdwg::Generator<std::tuple<const N&, const N&, const E&>>
+gdwg::Graph<N, E>::OutEdges(const N& src) const {
+  Count(&GraphStats::index_lookups);
+  auto node = nodes_.find(Key(src));
+  if (node == nodes_.end()) {
+    throw std::out_of_range{"Cannot call Graph::OutEdges if src doesn't exist in the graph"};
+  }
+  return EdgesOf(node->second.get());
+}
+
+template <typename N, typename E>
+gdwg::Generator<std::tuple<const N&, const N&, const E&>>
+gdwg::Graph<N, E>::EdgesOf(const Node* node) {
+  for (const auto& e : node->edges_) {
+    if (auto dst = e.first.lock()) {
+      co_yield std::tuple<const N&, const N&, const E&>{*node->value_, *dst, e.second};
+    }
+  }
+}
+
+template <typename N, typename E>
+gdwg::Generator<std::pair<const N&, std::size_t>>
+gdwg::Graph<N, E>::BreadthFirst(const Graph& g, const Node* src) {
+  std::unordered_set<const Node*> seen{src};
+  std::deque<std::pair<const Node*, std::size_t>> queue{{src, 0}};
+  while (!queue.empty()) {
+    auto [node, hops] = queue.front();
+    queue.pop_front();
+    co_yield std::pair<const N&, std::size_t>{*node->value_, hops};
+    for (const auto& e : node->edges_) {
+      if (auto dst = e.first.lock()) {
+        const Node* next = g.NodeOf(dst);
+        if (seen.insert(next).second) {
+          queue.emplace_back(next, hops + 1);
+        }
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+gdwg::Generator<std::pair<const N&, std::size_t>> gdwg::BfsOrder(const gdwg::Graph<N, E>& g,
+                                                                  const N& src) {
+  g.Count(&GraphStats::index_lookups);
+  auto node = g.nodes_.find(g.Key(src));
+  if (node == g.nodes_.end()) {
+    throw std::out_of_range{"Cannot call gdwg::BfsOrder if src doesn't exist in the graph"};
+  }
+  return gdwg::Graph<N, E>::BreadthFirst(g, node->second.get());
+}
+
+#endif  // defined(__cpp_impl_coroutine)
+
+/////////////////
+// PERSISTENCE //
+/////////////////
+
+namespace gdwg {
+namespace detail {
+
+constexpr char kSnapshotMagic[] = {'G', 'D', 'W', 'G'};
+constexpr std::uint32_t kSnapshotFormat = 1;
+constexpr std::uint8_t kSnapshotOrdered = 1;
+constexpr std::uint8_t kSnapshotWeightIndex = 2;
+
+}  // namespace detail
+}  // namespace gdwg
+
+// magic, format, flags, node count, the nodes in order, then for each node in the same order
+// its live out-degree followed by (dst, weight) pairs
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Snapshot(std::ostream& out) const {
+  constexpr std::size_t kChunk = std::size_t{1} << 20;
+  std::string buffer{detail::kSnapshotMagic, sizeof(detail::kSnapshotMagic)};
+  auto spill = [&out, &buffer] {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+  };
+  std::uint8_t flags = (ordered_ ? detail::kSnapshotOrdered : 0) |
+                       (weight_index_ ? detail::kSnapshotWeightIndex : 0);
+  Codec<std::uint32_t>::Encode(buffer, detail::kSnapshotFormat);
+  Codec<std::uint8_t>::Encode(buffer, flags);
+  Codec<std::uint64_t>::Encode(buffer, nodes_.size());
+  for (const auto& node : nodes_) {
+    Codec<N>::Encode(buffer, *node.first);
+    if (buffer.size() >= kChunk) {
+      spill();
+    }
+  }
+  for (const auto& node : nodes_) {
+    const auto& edges = node.second->edges_;
+    auto live = std::count_if(edges.begin(), edges.end(),
+                              [](const auto& e) { return !e.first.expired(); });
+    Codec<std::uint64_t>::Encode(buffer, static_cast<std::uint64_t>(live));
+    for (const auto& e : edges) {
+      if (auto dst = e.first.lock()) {
+        Codec<N>::Encode(buffer, *dst);
+        Codec<E>::Encode(buffer, e.second);
+      }
+    }
+    if (buffer.size() >= kChunk) {
+      spill();
+    }
+  }
+  spill();
+  if (!out) {
+    throw std::runtime_error{"Cannot call Graph::Snapshot when the output stream fails"};
+  }
+}
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::Recover(std::istream& snapshot, std::istream& log) {
+  std::string data{std::istreambuf_iterator<char>{snapshot}, std::istreambuf_iterator<char>{}};
+  const char* in = data.data();
+  const char* end = in + data.size();
+  auto read = [&in, end](auto& val) {
+    if (!Codec<std::decay_t<decltype(val)>>::Decode(in, end, val)) {
+      throw std::runtime_error{"Cannot call Graph::Recover with a malformed snapshot"};
+    }
+  };
+  std::uint32_t format = 0;
+  std::uint8_t flags = 0;
+  std::uint64_t count = 0;
+  if (data.compare(0, sizeof(detail::kSnapshotMagic), detail::kSnapshotMagic,
+                   sizeof(detail::kSnapshotMagic)) != 0) {
+    throw std::runtime_error{"Cannot call Graph::Recover with a malformed snapshot"};
+  }
+  in += sizeof(detail::kSnapshotMagic);
+  read(format);
+  if (format != detail::kSnapshotFormat) {
+    throw std::runtime_error{"Cannot call Graph::Recover with an unsupported snapshot format"};
+  }
+  read(flags);
+  read(count);
+
+  // Built aside so a bad snapshot or log leaves this graph alone
+  gdwg::Graph<N, E> g;
+  std::vector<N> nodes;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    N val;
+    read(val);
+    g.InsertNode(val);
+    nodes.push_back(std::move(val));
+  }
+  std::vector<std::tuple<N, N, E>> edges;
+  for (const auto& src : nodes) {
+    std::uint64_t degree = 0;
+    read(degree);
+    for (std::uint64_t i = 0; i < degree; ++i) {
+      N dst;
+      E w;
+      read(dst);
+      read(w);
+      edges.emplace_back(src, std::move(dst), std::move(w));
+    }
+    if (!edges.empty()) {
+      g.InsertEdges(std::move(edges));
+      edges.clear();
+    }
+  }
+  if (in != end) {
+    throw std::runtime_error{"Cannot call Graph::Recover with a malformed snapshot"};
+  }
+  if (flags & detail::kSnapshotOrdered) {
+    g.EnableTopologicalOrder();
+  }
+  if (flags & detail::kSnapshotWeightIndex) {
+    g.EnableWeightIndex();
+  }
+
+  JournalReader reader{log};
+  std::size_t replayed = 0;
+  try {
+    for (JournalOp op; reader.Next(op); ++replayed) {
+      N a;
+      N b;
+      E w;
+      switch (op) {
+        case JournalOp::kInsertNode:
+          reader.Read(a);
+          g.InsertNode(a);
+          break;
+        case JournalOp::kInsertEdge:
+          reader.Read(a);
+          reader.Read(b);
+          reader.Read(w);
+          g.InsertEdge(a, b, w);
+          break;
+        case JournalOp::kErase:
+          reader.Read(a);
+          reader.Read(b);
+          reader.Read(w);
+          g.erase(a, b, w);
+          break;
+        case JournalOp::kDeleteNode:
+          reader.Read(a);
+          g.DeleteNode(a);
+          break;
+        case JournalOp::kReplace:
+          reader.Read(a);
+          reader.Read(b);
+          g.Replace(a, b);
+          break;
+        case JournalOp::kMergeReplace:
+          reader.Read(a);
+          reader.Read(b);
+          g.MergeReplace(a, b);
+          break;
+        case JournalOp::kClear:
+          g.Clear();
+          break;
+        default:
+          throw std::runtime_error{"Cannot call Graph::Recover with a corrupt log record"};
+      }
+    }
+  } catch (const std::exception&) {
+    throw std::runtime_error{"Cannot call Graph::Recover with a log that doesn't apply to the "
+                             "snapshot"};
+  }
+
+  // Subscribers still hear about the new contents, but the log already has them
+  auto* journal = std::exchange(journal_, nullptr);
+  *this = std::move(g);
+  journal_ = journal;
+  return replayed;
+}
+
+// Records the whole graph as a Clear followed by its nodes and edges, for assignments that
+// replace the contents outright
+template <typename N, typename E>
+void gdwg::Graph<N, E>::EmitContents() {
+  if (muted_) {
+    return;
+  }
+  if (journal_ == nullptr && subscribers_.empty()) {
+    // Nobody is listening, so skip the walk but keep the sequence numbers the same
+    sequence_ += 1 + nodes_.size() + num_edges_;
+    return;
+  }
+  Emit<JournalOp::kClear>();
+  for (const auto& node : nodes_) {
+    Emit<JournalOp::kInsertNode>(*node.first);
+  }
+  for (const auto& node : nodes_) {
+    for (const auto& e : node.second->edges_) {
+      if (auto dst = e.first.lock()) {
+        Emit<JournalOp::kInsertEdge>(*node.first, *dst, e.second);
+      }
+    }
+  }
+}
+
+/////////////////
+// CHANGE FEED //
+/////////////////
+
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::Subscribe(
+    std::function<void(const gdwg::GraphChange<N, E>&)> callback) {
+  subscribers_.emplace_back(next_subscriber_, std::move(callback));
+  return next_subscriber_++;
+}
+
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::Unsubscribe(std::size_t id) noexcept {
+  auto found = std::find_if(subscribers_.begin(), subscribers_.end(),
+                            [id](const auto& subscriber) { return subscriber.first == id; });
+  if (found == subscribers_.end()) {
+    return false;
+  }
+  subscribers_.erase(found);
+  return true;
+}
+
+/////////////////////
+// INSTRUMENTATION //
+/////////////////////
+
+template <typename N, typename E>
+gdwg::GraphStats gdwg::Graph<N, E>::Stats() const noexcept {
+#ifdef GDWG_GRAPH_STATS
+  return stats_;
+#else
+  return {};
+#endif
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::ResetStats() noexcept {
+#ifdef GDWG_GRAPH_STATS
+  stats_ = {};
+#endif
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Count([[maybe_unused]] std::size_t GraphStats::*counter,
+                              [[maybe_unused]] std::size_t n) const noexcept {
+#ifdef GDWG_GRAPH_STATS
+  stats_.*counter += n;
+#endif
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::RecordDuplicateScan([[maybe_unused]] std::size_t scanned) const noexcept {
+#ifdef GDWG_GRAPH_STATS
+  ++stats_.duplicate_checks;
+  stats_.duplicate_scan_length += scanned;
+  stats_.longest_duplicate_scan = std::max(stats_.longest_duplicate_scan, scanned);
+#endif
+}
+
+///////////////////
+// EDGE COUNTING //
+///////////////////
+
+// Removes node's edges to deleted nodes, returning how many were removed
+template <typename N, typename E>
+std::size_t gdwg::Graph<N, E>::Purge(Node* node) const {
+  auto before = node->edges_.size();
+  node->edges_.remove_if([](const auto& e) { return e.first.expired(); });
+  auto removed = before - node->edges_.size();
+  tombstones_ -= removed;
+  return removed;
+}
+
+// Recomputes every counter from scratch, dropping all tombstones on the way
+template <typename N, typename E>
+void gdwg::Graph<N, E>::Recount() {
+  num_edges_ = 0;
+  for (auto& node : nodes_) {
+    node.second->edges_.remove_if([](const auto& e) { return e.first.expired(); });
+    node.second->in_degree_ = 0;
+    node.second->out_degree_ = node.second->edges_.size();
+  }
+  for (auto& node : nodes_) {
+    for (const auto& e : node.second->edges_) {
+      ++NodeOf(e.first.lock())->in_degree_;
+    }
+    num_edges_ += node.second->edges_.size();
+  }
+  tombstones_ = 0;
+}
+
+//////////////////////////
+// TOPOLOGICAL ORDERING //
+//////////////////////////
+
+// Kahn's algorithm over the whole graph, also rebuilding the incoming lists
+template <typename N, typename E>
+void gdwg::Graph<N, E>::RebuildOrder() {
+  std::vector<Node*> order;
+  order.reserve(nodes_.size());
+  for (auto& node : nodes_) {
+    node.second->topo_ = std::make_unique<OrderState>();
+  }
+  for (auto& node : nodes_) {
+    for (const auto& e : node.second->edges_) {
+      if (auto dst = e.first.lock()) {
+        NodeOf(dst)->topo_->in_.push_back(node.second.get());
+      }
+    }
+  }
+  std::map<Node*, std::size_t> remaining;
+  for (auto& node : nodes_) {
+    remaining[node.second.get()] = node.second->topo_->in_.size();
+    if (node.second->topo_->in_.empty()) {
+      order.push_back(node.second.get());
+    }
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    for (const auto& e : order[i]->edges_) {
+      if (auto dst = e.first.lock()) {
+        Node* next = NodeOf(dst);
+        if (--remaining[next] == 0) {
+          order.push_back(next);
+        }
+      }
+    }
+  }
+  if (order.size() != nodes_.size()) {
+    for (auto& node : nodes_) {
+      node.second->topo_.reset();
+    }
+    throw std::runtime_error{"Cannot call Graph::EnableTopologicalOrder on a graph with a cycle"};
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i]->topo_->ord_ = i;
+  }
+  order_ = std::move(order);
+}
+
+// Pearce-Kelly: only the nodes between dst and src in the current order are searched and
+// shuffled. Returns false, leaving the order untouched, if src is reachable from dst.
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::ReorderForEdge(Node* src, Node* dst) {
+  if (src == dst) {
+    return false;
+  }
+  auto lower = dst->topo_->ord_;
+  auto upper = src->topo_->ord_;
+  if (lower > upper) {
+    return true;
+  }
+
+  std::vector<Node*> forward;
+  std::unordered_set<Node*> seen{dst};
+  std::vector<Node*> stack{dst};
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    forward.push_back(node);
+    for (const auto& e : node->edges_) {
+      if (auto next_value = e.first.lock()) {
+        Node* next = NodeOf(next_value);
+        if (next == src) {
+          return false;
+        }
+        if (next->topo_->ord_ < upper && seen.insert(next).second) {
+          stack.push_back(next);
+        }
+      }
+    }
+  }
+
+  std::vector<Node*> backward;
+  stack.push_back(src);
+  seen.insert(src);
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    backward.push_back(node);
+    for (auto prev : node->topo_->in_) {
+      if (prev->topo_->ord_ > lower && seen.insert(prev).second) {
+        stack.push_back(prev);
+      }
+    }
+  }
+
+  // Everything that reaches src moves ahead of everything dst reaches, reusing their slots
+  auto by_ord = [](const Node* a, const Node* b) { return a->topo_->ord_ < b->topo_->ord_; };
+  std::sort(forward.begin(), forward.end(), by_ord);
+  std::sort(backward.begin(), backward.end(), by_ord);
+  std::vector<std::size_t> slots;
+  slots.reserve(forward.size() + backward.size());
+  for (auto node : backward) {
+    slots.push_back(node->topo_->ord_);
+  }
+  for (auto node : forward) {
+    slots.push_back(node->topo_->ord_);
+  }
+  std::sort(slots.begin(), slots.end());
+  auto slot = slots.cbegin();
+  for (auto node : backward) {
+    node->topo_->ord_ = *slot++;
+    order_[node->topo_->ord_] = node;
+  }
+  for (auto node : forward) {
+    node->topo_->ord_ = *slot++;
+    order_[node->topo_->ord_] = node;
+  }
+  return true;
+}
+
+// Depth-first search that never leaves the part of the order between from and to
+template <typename N, typename E>
+bool gdwg::Graph<N, E>::Reaches(Node* from, Node* to) const {
+  if (from->topo_->ord_ > to->topo_->ord_) {
+    return false;
+  }
+  std::unordered_set<Node*> seen{from};
+  std::vector<Node*> stack{from};
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    for (const auto& e : node->edges_) {
+      if (auto next_value = e.first.lock()) {
+        Node* next = NodeOf(next_value);
+        if (next == to) {
+          return true;
+        }
+        if (next->topo_->ord_ < to->topo_->ord_ && seen.insert(next).second) {
+          stack.push_back(next);
+        }
+      }
+    }
+  }
+  return false;
+}
+
+template <typename N, typename E>
+void gdwg::Graph<N, E>::DropInEdge(Node* src, Node* dst) {
+  auto it = std::find(dst->topo_->in_.begin(), dst->topo_->in_.end(), src);
+  if (it != dst->topo_->in_.end()) {
+    dst->topo_->in_.erase(it);
+  }
+}
+
 ///////////////
 // ITERATORS //
 ///////////////
@@ -364,6 +1506,7 @@ typename gdwg::Graph<N, E>::Iterator& gdwg::Graph<N, E>::Iterator::operator++()
       }
     }
     if (curr_node_ != it_end_) {
+      graph_->Count(&GraphStats::lazy_sorts);
       curr_node_->second->edges_.sort(Edge::edgeComparator);
       edge_it_ = curr_node_->second->edges_.cbegin();
     } else {
@@ -373,6 +1516,8 @@ typename gdwg::Graph<N, E>::Iterator& gdwg::Graph<N, E>::Iterator::operator++()
   // Clean up edge if it contains node that has been deleted
   if ((*edge_it_).first.expired()) {
     edge_it_ = curr_node_->second->edges_.erase(edge_it_);
+    --graph_->tombstones_;
+    graph_->Count(&GraphStats::read_cleanups);
     edge_it_--;
     *this = ++(*this);
   }
@@ -404,6 +1549,7 @@ typename gdwg::Graph<N, E>::Iterator& gdwg::Graph<N, E>::Iterator::operator--()
     while (curr_node_->second->edges_.cbegin() == curr_node_->second->edges_.end()) {
       --curr_node_;
     }
+    graph_->Count(&GraphStats::lazy_sorts);
     curr_node_->second->edges_.sort(Edge::edgeComparator);
     edge_it_ = curr_node_->second->edges_.cend();
   }
@@ -411,6 +1557,8 @@ typename gdwg::Graph<N, E>::Iterator& gdwg::Graph<N, E>::Iterator::operator--()
   // Clean up edge if it contains node that has been deleted
   if ((*edge_it_).first.expired()) {
     edge_it_ = curr_node_->second->edges_.erase(edge_it_);
+    --graph_->tombstones_;
+    graph_->Count(&GraphStats::read_cleanups);
     // edge_it_++;
     *this = --(*this);
   }
@@ -424,6 +1572,22 @@ typename gdwg::Graph<N, E>::Iterator gdwg::Graph<N, E>::Iterator::operator--(int
   return copy;
 }
 
+// Steps over list ends and edges to deleted nodes, without going past the end of the range
+template <typename N, typename E>
+void gdwg::Graph<N, E>::EdgeRange::Iterator::Settle() {
+  while (!At(stop_)) {
+    if (at_.second == at_.first->second->edges_.cend()) {
+      if (++at_.first != map_end_) {
+        at_.second = at_.first->second->edges_.cbegin();
+      }
+    } else if (at_.second->first.expired()) {
+      ++at_.second;
+    } else {
+      break;
+    }
+  }
+}
+
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cbegin() const {
   auto begin = nodes_.cbegin();
@@ -434,9 +1598,10 @@ typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cbegin() const {
   if (begin == last) {
     return cend();
   }
+  Count(&GraphStats::lazy_sorts);
   begin->second->edges_.sort(Edge::edgeComparator);
   auto edges = begin->second->edges_.cbegin();
-  const_iterator it{last, begin, edges};
+  const_iterator it{last, begin, edges, this};
   // make sure edge has not expired
   while ((*it.edge_it_).first.expired()) {
     // std::cout << "FIRST EDGE IT EXPIRED\n";
@@ -450,5 +1615,5 @@ typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cbegin() const {
 
 template <typename N, typename E>
 typename gdwg::Graph<N, E>::const_iterator gdwg::Graph<N, E>::cend() const {
-  return const_iterator{nodes_.cend(), nodes_.cend(), {}};
+  return const_iterator{nodes_.cend(), nodes_.cend(), {}, this};
 }
@@ -0,0 +1,314 @@
+// Benchmarks every Graph operation over a sweep of sizes and degree distributions and writes
+// the timings as JSON, so a performance change can be checked against the numbers before it.
+//
+// Usage: graph_bench [--min_edges=N] [--max_edges=N] [--distributions=uniform,powerlaw]
+//                    [--repetitions=N] [--seed=N] [--out=FILE]
+//
+// Sizes go up by a factor of 10 from min_edges to max_edges (10^3 to 10^7 by default), with
+// an average out-degree of 8. Each operation is timed repetitions times on fresh input and the
+// fastest and median runs are reported, in nanoseconds per call.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace {
+
+using Graph = gdwg::Graph<int, int>;
+using Edges = std::vector<std::tuple<int, int, int>>;
+
+constexpr std::size_t kAverageDegree = 8;
+// Most operations are timed over a random sample of this many calls
+constexpr std::size_t kSample = 10000;
+// find and MergeReplace walk the whole graph, so they get this many edge visits in total
+constexpr std::size_t kScanBudget = 1000000;
+
+struct Options {
+  std::size_t min_edges = 1000;
+  std::size_t max_edges = 10000000;
+  std::vector<std::string> distributions{"uniform", "powerlaw"};
+  std::size_t repetitions = 3;
+  std::uint64_t seed = 1;
+  std::string out;
+};
+
+struct Result {
+  std::string operation;
+  std::string distribution;
+  std::size_t nodes;
+  std::size_t edges;
+  std::size_t calls;
+  double min_ns;
+  double median_ns;
+};
+
+// Keeps results alive so the optimiser can't drop the calls that produced them
+volatile std::size_t sink;
+
+std::vector<std::string> Split(const std::string& list) {
+  std::vector<std::string> parts;
+  std::stringstream ss{list};
+  for (std::string part; std::getline(ss, part, ',');) {
+    if (!part.empty()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    auto eq = arg.find('=');
+    auto key = arg.substr(0, eq);
+    auto value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--min_edges") {
+      options.min_edges = std::stoull(value);
+      if (options.min_edges == 0) {
+        // Sizes grow by multiplying, so zero would never reach max_edges
+        throw std::invalid_argument{"--min_edges must be at least 1"};
+      }
+    } else if (key == "--max_edges") {
+      options.max_edges = std::stoull(value);
+    } else if (key == "--distributions") {
+      options.distributions = Split(value);
+    } else if (key == "--repetitions") {
+      options.repetitions = std::max<std::size_t>(std::stoull(value), 1);
+    } else if (key == "--seed") {
+      options.seed = std::stoull(value);
+    } else if (key == "--out") {
+      options.out = value;
+    } else {
+      throw std::invalid_argument{"Unknown flag " + arg};
+    }
+  }
+  for (const auto& distribution : options.distributions) {
+    if (distribution != "uniform" && distribution != "powerlaw") {
+      throw std::invalid_argument{"Unknown distribution " + distribution};
+    }
+  }
+  return options;
+}
+
+// uniform picks both endpoints uniformly. powerlaw squares a uniform draw for each endpoint,
+// so low-numbered nodes become hubs with degree around edges / sqrt(nodes).
+Edges MakeEdges(const std::string& distribution,
+                std::size_t nodes,
+                std::size_t edges,
+                std::uint64_t seed) {
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<double> unit{0.0, 1.0};
+  std::uniform_int_distribution<int> weight{0, 99};
+  auto pick = [&] {
+    auto u = unit(rng);
+    if (distribution == "powerlaw") {
+      u *= u;
+    }
+    return std::min(static_cast<int>(u * static_cast<double>(nodes)), static_cast<int>(nodes) - 1);
+  };
+  Edges list;
+  list.reserve(edges);
+  for (std::size_t i = 0; i < edges; ++i) {
+    auto src = pick();
+    auto dst = pick();
+    list.emplace_back(src, dst, weight(rng));
+  }
+  return list;
+}
+
+// Graph's copy and move constructors are explicit, so this fills in a graph instead of
+// returning one
+void Build(Graph& g, std::size_t nodes, const Edges& edges) {
+  for (std::size_t i = 0; i < nodes; ++i) {
+    g.InsertNode(static_cast<int>(i));
+  }
+  for (const auto& [src, dst, w] : edges) {
+    g.InsertEdge(src, dst, w);
+  }
+}
+
+template <typename T>
+std::vector<T> Sample(const std::vector<T>& from, std::size_t count, std::mt19937_64& rng) {
+  std::vector<T> sample;
+  sample.reserve(count);
+  std::uniform_int_distribution<std::size_t> index{0, from.size() - 1};
+  for (std::size_t i = 0; i < count; ++i) {
+    sample.push_back(from[index(rng)]);
+  }
+  return sample;
+}
+
+// Runs setup then body repetitions times and times only body, which returns how many calls it
+// made
+Result Measure(const std::string& operation,
+               std::size_t repetitions,
+               const std::function<void()>& setup,
+               const std::function<std::size_t()>& body) {
+  std::vector<double> per_call;
+  std::size_t calls = 0;
+  for (std::size_t r = 0; r < repetitions; ++r) {
+    setup();
+    auto start = std::chrono::steady_clock::now();
+    calls = body();
+    auto stop = std::chrono::steady_clock::now();
+    auto ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    per_call.push_back(ns / static_cast<double>(std::max<std::size_t>(calls, 1)));
+  }
+  std::sort(per_call.begin(), per_call.end());
+  return Result{operation, "", 0, 0, calls, per_call.front(), per_call[per_call.size() / 2]};
+}
+
+std::vector<Result> RunSize(const std::string& distribution,
+                            std::size_t edge_count,
+                            const Options& options) {
+  auto node_count = std::max<std::size_t>(edge_count / kAverageDegree, 2);
+  auto edges = MakeEdges(distribution, node_count, edge_count, options.seed);
+  std::mt19937_64 rng{options.seed + 1};
+  auto queries = Sample(edges, std::min(kSample, edges.size()), rng);
+  auto scans = std::max<std::size_t>(kScanBudget / edge_count, 1);
+  auto find_queries = Sample(edges, std::min(scans, edges.size()), rng);
+  auto reps = options.repetitions;
+
+  std::vector<Result> results;
+  Graph g;
+  auto nothing = [] {};
+
+  results.push_back(Measure("insert", reps, [&] { g = Graph{}; }, [&] {
+    Build(g, node_count, edges);
+    return node_count + edges.size();
+  }));
+  results.push_back(Measure("lookup", reps, nothing, [&] {
+    std::size_t hits = 0;
+    for (const auto& [src, dst, w] : queries) {
+      hits += g.IsNode(src) + g.IsConnected(src, dst);
+    }
+    sink = hits;
+    return 2 * queries.size();
+  }));
+  results.push_back(Measure("GetConnected", reps, nothing, [&] {
+    std::size_t total = 0;
+    for (const auto& query : queries) {
+      total += g.GetConnected(std::get<0>(query)).size();
+    }
+    sink = total;
+    return queries.size();
+  }));
+  results.push_back(Measure("GetWeights", reps, nothing, [&] {
+    std::size_t total = 0;
+    for (const auto& [src, dst, w] : queries) {
+      total += g.GetWeights(src, dst).size();
+    }
+    sink = total;
+    return queries.size();
+  }));
+  results.push_back(Measure("find", reps, nothing, [&] {
+    std::size_t hits = 0;
+    for (const auto& [src, dst, w] : find_queries) {
+      hits += g.find(src, dst, w) != g.cend();
+    }
+    sink = hits;
+    return find_queries.size();
+  }));
+  results.push_back(Measure("iteration", reps, nothing, [&] {
+    std::size_t total = 0;
+    for (const auto& [src, dst, w] : g) {
+      total += static_cast<std::size_t>(src + dst + w);
+    }
+    sink = total;
+    return g.NumEdges();
+  }));
+  Graph copy;
+  results.push_back(Measure("copy", reps, [&] { copy = Graph{}; }, [&] {
+    copy = Graph{g};
+    return std::size_t{1};
+  }));
+  results.push_back(Measure("operator==", reps, nothing, [&] {
+    sink = g == copy;
+    return std::size_t{1};
+  }));
+  results.push_back(Measure("operator<<", reps, nothing, [&] {
+    std::ostringstream os;
+    os << g;
+    sink = os.str().size();
+    return std::size_t{1};
+  }));
+  results.push_back(Measure("erase", reps, [&] { copy = Graph{g}; }, [&] {
+    std::size_t erased = 0;
+    for (const auto& [src, dst, w] : queries) {
+      erased += copy.erase(src, dst, w);
+    }
+    sink = erased;
+    return queries.size();
+  }));
+  // Merge distinct pairs of nodes so every call does real work
+  results.push_back(Measure("MergeReplace", reps, [&] { copy = Graph{g}; }, [&] {
+    auto merges = std::min(scans, node_count / 2);
+    for (std::size_t i = 0; i < merges; ++i) {
+      copy.MergeReplace(static_cast<int>(2 * i + 1), static_cast<int>(2 * i));
+    }
+    return merges;
+  }));
+
+  // Duplicate (src, dst, w) draws are rejected by InsertEdge, so report what g really holds
+  for (auto& result : results) {
+    result.distribution = distribution;
+    result.nodes = node_count;
+    result.edges = g.NumEdges();
+  }
+  return results;
+}
+
+void WriteJson(std::ostream& os, const std::vector<Result>& results) {
+  os << "{\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\"operation\": \"" << r.operation
+       << "\", \"distribution\": \"" << r.distribution << "\", \"nodes\": " << r.nodes
+       << ", \"edges\": " << r.edges << ", \"calls\": " << r.calls
+       << ", \"min_ns_per_call\": " << r.min_ns << ", \"median_ns_per_call\": " << r.median_ns
+       << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  try {
+    options = ParseOptions(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  std::vector<Result> results;
+  for (const auto& distribution : options.distributions) {
+    for (auto edges = options.min_edges; edges <= options.max_edges; edges *= 10) {
+      std::cerr << distribution << " " << edges << " edges\n";
+      auto size_results = RunSize(distribution, edges, options);
+      results.insert(results.end(), size_results.begin(), size_results.end());
+    }
+  }
+
+  if (options.out.empty()) {
+    WriteJson(std::cout, results);
+  } else {
+    std::ofstream file{options.out};
+    WriteJson(file, results);
+  }
+  return 0;
+}
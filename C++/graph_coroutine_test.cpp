@@ -0,0 +1,111 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The lazy queries are coroutines and need C++20 (this file is built with -std=c++2a, marked
+  GATE_CXX20 for the local build script). They are checked for the results they yield and
+  for being lazy, which is the reason they exist:
+  * Edges yields every edge exactly once, in the same order as the const_iterator
+  * Stopping after the first edge leaves the rest of the graph unvisited, so a mutation
+    made afterwards is never seen
+  * OutEdges yields only src's edges, skips edges to deleted nodes, and throws for an
+    unknown src before any coroutine starts
+  * BfsOrder yields each reachable node once with its hop count, never reaches nodes that
+    are only reachable backwards, and throws for an unknown src
+
+*/
+
+#include "assignments/dg/graph.h"
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "catch.h"
+
+#if defined(__cpp_impl_coroutine)
+
+SCENARIO("Lazily walking edges") {
+  GIVEN("A graph with a few edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 2);
+    g.InsertEdge("b", "c", 3);
+    g.InsertEdge("c", "a", 4);
+
+    THEN("Edges yields the same edges as iterating the graph") {
+      std::vector<std::tuple<std::string, std::string, int>> lazy;
+      for (const auto& [src, dst, w] : g.Edges()) {
+        lazy.emplace_back(src, dst, w);
+      }
+      std::vector<std::tuple<std::string, std::string, int>> eager{g.cbegin(), g.cend()};
+      REQUIRE(lazy == eager);
+    }
+
+    WHEN("The caller stops after the first edge") {
+      auto edges = g.Edges();
+      auto it = edges.begin();
+      REQUIRE(std::get<0>(*it) == "a");
+      THEN("Nothing further has been computed yet") {
+        g.InsertEdge("d", "a", 5);
+        std::vector<std::string> sources;
+        for (; it != edges.end(); ++it) {
+          sources.push_back(std::get<0>(*it));
+        }
+        REQUIRE(sources.back() == "d");
+      }
+    }
+
+    WHEN("A destination is deleted") {
+      g.DeleteNode("b");
+      THEN("OutEdges skips the edge to it") {
+        std::vector<std::string> dsts;
+        for (const auto& [src, dst, w] : g.OutEdges("a")) {
+          REQUIRE(src == "a");
+          dsts.push_back(dst);
+        }
+        REQUIRE(dsts == std::vector<std::string>{"c"});
+      }
+    }
+
+    THEN("OutEdges of an unknown node throws straight away") {
+      REQUIRE_THROWS_WITH(g.OutEdges("z"),
+                          "Cannot call Graph::OutEdges if src doesn't exist in the graph");
+    }
+  }
+}
+
+SCENARIO("Breadth-first order") {
+  GIVEN("A chain with a shortcut and a node that only points in") {
+    gdwg::Graph<int, int> g{1, 2, 3, 4, 5};
+    g.InsertEdge(1, 2, 0);
+    g.InsertEdge(2, 3, 0);
+    g.InsertEdge(3, 4, 0);
+    g.InsertEdge(1, 3, 0);
+    g.InsertEdge(3, 1, 0);
+    g.InsertEdge(5, 1, 0);
+
+    THEN("Each reachable node is yielded once with its distance") {
+      std::vector<std::pair<int, std::size_t>> order;
+      for (const auto& [node, hops] : gdwg::BfsOrder(g, 1)) {
+        order.emplace_back(node, hops);
+      }
+      REQUIRE(order == std::vector<std::pair<int, std::size_t>>{{1, 0}, {2, 1}, {3, 1}, {4, 2}});
+    }
+
+    THEN("Stopping early only visits the start") {
+      auto bfs = gdwg::BfsOrder(g, 5);
+      auto it = bfs.begin();
+      REQUIRE((*it).first == 5);
+      REQUIRE((*it).second == 0);
+    }
+
+    THEN("An unknown start throws") {
+      REQUIRE_THROWS_WITH(gdwg::BfsOrder(g, 9),
+                          "Cannot call gdwg::BfsOrder if src doesn't exist in the graph");
+    }
+  }
+}
+
+#endif  // defined(__cpp_impl_coroutine)
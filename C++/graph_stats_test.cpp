@@ -0,0 +1,99 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  This file is built with GDWG_GRAPH_STATS defined so the hot-path counters are collected.
+  Each scenario resets the counters, performs one kind of operation, and checks that only
+  the work that operation is expected to hide shows up:
+  * IsNode and the getters count node map lookups and the temporary probe keys and edge
+    list copies they make
+  * InsertEdge records how many edges its duplicate check scanned, and the longest scan
+  * Iterating sorts each edge list it enters, and cleans up edges to deleted nodes
+  * Printing the graph sorts and cleans up the same way
+  * OutDegree and DegreeHistogram clean up nothing
+  * ResetStats zeroes every counter
+
+*/
+
+#define GDWG_GRAPH_STATS
+
+#include "assignments/dg/graph.h"
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "catch.h"
+
+SCENARIO("Counting the work hidden in reads and writes") {
+  GIVEN("A graph with a few edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "c", 2);
+    g.InsertEdge("b", "c", 3);
+    g.ResetStats();
+    REQUIRE(g.Stats().index_lookups == 0);
+
+    WHEN("Nodes are looked up") {
+      g.IsNode("a");
+      g.IsNode("z");
+      THEN("Each lookup builds a probe key") {
+        REQUIRE(g.Stats().index_lookups == 2);
+        REQUIRE(g.Stats().temporary_allocations == 2);
+      }
+    }
+    WHEN("GetWeights copies an edge list") {
+      g.GetWeights("a", "b");
+      THEN("The copied cells are counted as temporaries") {
+        // Two probe keys from the existence checks, one for the lookup, two copied cells
+        REQUIRE(g.Stats().temporary_allocations == 5);
+        REQUIRE(g.Stats().index_lookups == 3);
+      }
+    }
+    WHEN("Edges are inserted into a growing list") {
+      g.InsertEdge("a", "c", 2);
+      g.InsertEdge("a", "a", 4);
+      THEN("The duplicate check scan lengths are recorded") {
+        auto stats = g.Stats();
+        REQUIRE(stats.duplicate_checks == 2);
+        // The duplicate is found as the second edge, the new edge scans both
+        REQUIRE(stats.duplicate_scan_length == 4);
+        REQUIRE(stats.longest_duplicate_scan == 2);
+      }
+    }
+    WHEN("The graph is iterated after a node is deleted") {
+      g.DeleteNode("c");
+      g.ResetStats();
+      std::size_t seen = 0;
+      for (auto it = g.cbegin(); it != g.cend(); ++it) {
+        ++seen;
+      }
+      THEN("Lazy sorts and cleanups done by the iterator are counted") {
+        REQUIRE(seen == 1);
+        REQUIRE(g.Stats().lazy_sorts >= 1);
+        REQUIRE(g.Stats().read_cleanups == 1);
+      }
+      AND_WHEN("The graph is printed") {
+        g.ResetStats();
+        std::ostringstream os;
+        os << g;
+        THEN("Every node's list is sorted and the last edge to c is cleaned up") {
+          REQUIRE(g.Stats().lazy_sorts == 2);
+          REQUIRE(g.Stats().read_cleanups == 1);
+        }
+      }
+    }
+    WHEN("Degrees are read after a node is deleted") {
+      g.DeleteNode("c");
+      g.ResetStats();
+      THEN("They leave both edges to c for a later read to clean up") {
+        REQUIRE(g.OutDegree("a") == 1);
+        REQUIRE(g.DegreeHistogram() == std::map<std::size_t, std::size_t>{{0, 1}, {1, 1}});
+        REQUIRE(g.Stats().read_cleanups == 0);
+        std::ostringstream os;
+        os << g;
+        REQUIRE(g.Stats().read_cleanups == 2);
+      }
+    }
+  }
+}
@@ -78,6 +78,7 @@
       - Ensure all edges to oldNode now point to newNode
       - Ensure all edges from oldNode now from newNode
       - Ensure any edges that may have been duplicated in the process have been removed
+    - merging a node into itself leaves the graph unchanged, ordered or not
   * Clear
     - All nodes have been removed
     - new nodes can be added to cleared graph
@@ -88,14 +89,51 @@
   * Iterators
     - forward and reverse iterators
     - valid increment and decrement operations
+  * Topological order
+    - enabling on a graph with a cycle
+    - order respected after edges that force a reorder
+    - edges and merges that would close a cycle are refused
+    - order kept after deleting nodes and copying the graph
+  * Weight-ordered edge queries, with and without the weight index
+    - src or dst does not exist
+    - TopKEdges returns the k cheapest edges with ties broken by dst
+    - EdgesInWeightRange is inclusive and skips edges to deleted nodes
+    - MinWeight and MaxWeight between a pair, and between unconnected nodes
+    - index kept up to date through erase, DeleteNode and MergeReplace
+  * Counters
+    - size, NumEdges, OutDegree and DegreeHistogram agree with iterating the graph
+    - kept up to date through erase, DeleteNode (with edges left to clean up), MergeReplace,
+      Clear and move
+  * MemoryUsage
+    - grows with nodes and edges, and an empty graph only costs the Graph object
+    - long strings report their heap buffer, short ones don't
+    - custom types report heap usage through a HeapUsage() member
+    - nothing is spent on the topological order or weight index until they are enabled
+  * EdgeRanges
+    - zero ranges throws, an empty graph gives empty ranges
+    - ranges are balanced by edge count even when one node holds most edges
+    - together they visit every edge once, also when walked from several threads
+    - edges to deleted nodes are skipped without being cleaned up
+  * InsertEdges
+    - only edges not already present are added, whatever order the batch is in
+    - a missing endpoint throws before any edge is added
+    - counters and the weight index are kept up to date
+    - with a topological order, an edge closing a cycle still throws
+  * InducedSubgraph
+    - same graph as copying and deleting every other node, whatever order nodes are given in
+    - independent of the original afterwards, and keeps its topological order and weight index
+    - an unknown node throws
 
 */
 
 #include "assignments/dg/graph.h"
 
 #include <iostream>
+#include <iterator>
+#include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <typeinfo>
 #include <vector>
 
@@ -654,6 +692,24 @@ SCENARIO("Merge replacing a graphs node with another node") {
         REQUIRE(edges.at(0) == 0);
       }
     }
+    WHEN("You merge a node into itself") {
+      gdwg::Graph<std::string, int> before{g};
+      g.MergeReplace("first", "first");
+      THEN("Nothing changes") {
+        REQUIRE(g == before);
+        REQUIRE(g.NumEdges() == 3);
+      }
+    }
+    WHEN("You merge a node into itself while a topological order is kept") {
+      g.EnableTopologicalOrder();
+      gdwg::Graph<std::string, int> before{g};
+      g.MergeReplace("first", "first");
+      THEN("Nothing changes and the order is kept") {
+        REQUIRE(g == before);
+        REQUIRE(g.MaintainsTopologicalOrder());
+        REQUIRE(g.TopologicalOrder() == before.TopologicalOrder());
+      }
+    }
     WHEN("oldData node that does not exist") {
       THEN("Require to catch throw runtime_error") {
         REQUIRE_THROWS_WITH(
@@ -995,3 +1051,486 @@ SCENARIO("You can decrement over the graph using reverse iterator") {
     }
   }
 }
+
+SCENARIO("Maintaining a topological order while inserting edges") {
+  GIVEN("A graph with a cycle") {
+    gdwg::Graph<std::string, int> g{"a", "b"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "a", 1);
+    THEN("The order cannot be enabled") {
+      REQUIRE_THROWS_WITH(g.EnableTopologicalOrder(),
+                          "Cannot call Graph::EnableTopologicalOrder on a graph with a cycle");
+      REQUIRE(g.MaintainsTopologicalOrder() == false);
+    }
+  }
+
+  GIVEN("A DAG scheduler with the order enabled before any edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e"};
+    g.EnableTopologicalOrder();
+    g.InsertEdge("e", "d", 1);
+    g.InsertEdge("d", "c", 1);
+    g.InsertEdge("c", "b", 1);
+    g.InsertEdge("b", "a", 1);
+    g.InsertEdge("e", "a", 2);
+    auto respects_edges = [&g] {
+      auto order = g.TopologicalOrder();
+      for (auto it = g.cbegin(); it != g.cend(); ++it) {
+        auto src = std::find(order.begin(), order.end(), std::get<0>(*it));
+        auto dst = std::find(order.begin(), order.end(), std::get<1>(*it));
+        if (src >= dst) {
+          return false;
+        }
+      }
+      return order.size() == g.GetNodes().size();
+    };
+    THEN("Edges inserted against the initial order are respected") {
+      REQUIRE(g.TopologicalOrder() == std::vector<std::string>{"e", "d", "c", "b", "a"});
+    }
+    WHEN("An edge would close a cycle") {
+      THEN("It is refused and the graph is unchanged") {
+        REQUIRE_THROWS_WITH(g.InsertEdge("a", "e", 1),
+                            "Cannot call Graph::InsertEdge when the edge would create a cycle");
+        REQUIRE_THROWS_WITH(g.InsertEdge("c", "c", 1),
+                            "Cannot call Graph::InsertEdge when the edge would create a cycle");
+        REQUIRE(g.IsConnected("a", "e") == false);
+        REQUIRE(respects_edges());
+      }
+    }
+    WHEN("A merge would close a cycle") {
+      THEN("It is refused") {
+        REQUIRE_THROWS_WITH(g.MergeReplace("e", "b"),
+                            "Cannot call Graph::MergeReplace when merging would create a cycle");
+        REQUIRE(g.IsNode("e"));
+      }
+    }
+    WHEN("A node with edges into it is deleted") {
+      g.DeleteNode("a");
+      THEN("Its sources' out-degrees drop straight away") {
+        REQUIRE(g.OutDegree("b") == 0);
+        REQUIRE(g.OutDegree("e") == 1);
+        REQUIRE(g.NumEdges() == 3);
+      }
+    }
+    WHEN("Nodes are added, deleted and merged") {
+      g.InsertNode("f");
+      g.InsertEdge("a", "f", 1);
+      g.DeleteNode("c");
+      g.InsertEdge("b", "d", 1);
+      g.InsertNode("g");
+      g.InsertEdge("g", "f", 1);
+      g.MergeReplace("g", "b");
+      THEN("The order still respects every edge") {
+        REQUIRE(respects_edges());
+        REQUIRE(g.TopologicalOrder().size() == 5);
+      }
+    }
+    WHEN("The graph is copied") {
+      gdwg::Graph<std::string, int> copy{g};
+      THEN("The copy maintains its own order") {
+        REQUIRE(copy.MaintainsTopologicalOrder());
+        REQUIRE(copy.TopologicalOrder() == g.TopologicalOrder());
+        REQUIRE_THROWS(copy.InsertEdge("a", "e", 1));
+      }
+    }
+  }
+}
+
+SCENARIO("Querying out-edges by weight") {
+  GIVEN("A node with edges of assorted weights") {
+    gdwg::Graph<std::string, int> g{"hub", "a", "b", "c", "d"};
+    g.InsertEdge("hub", "c", 5);
+    g.InsertEdge("hub", "a", 3);
+    g.InsertEdge("hub", "b", 3);
+    g.InsertEdge("hub", "a", 9);
+    g.InsertEdge("hub", "d", 1);
+    g.InsertEdge("hub", "c", 7);
+    for (bool indexed : {false, true}) {
+      if (indexed) {
+        g.EnableWeightIndex();
+      }
+      REQUIRE(g.HasWeightIndex() == indexed);
+      THEN("Unknown nodes throw") {
+        REQUIRE_THROWS_WITH(g.TopKEdges("z", 1),
+                            "Cannot call Graph::TopKEdges if src doesn't exist in the graph");
+        REQUIRE_THROWS_WITH(g.MinWeight("hub", "z"),
+                            "Cannot call Graph::MinWeight if src or dst node don't exist in the "
+                            "graph");
+      }
+      THEN("TopKEdges returns the cheapest edges, ties broken by dst") {
+        using Edges = std::vector<std::pair<std::string, int>>;
+        REQUIRE(g.TopKEdges("hub", 3) == Edges{{"d", 1}, {"a", 3}, {"b", 3}});
+        REQUIRE(g.TopKEdges("hub", 2) == Edges{{"d", 1}, {"a", 3}});
+        REQUIRE(g.TopKEdges("hub", 10).size() == 6);
+        REQUIRE(g.TopKEdges("a", 3).empty());
+        REQUIRE(g.TopKEdges("hub", 0).empty());
+      }
+      THEN("EdgesInWeightRange is inclusive at both ends") {
+        using Edges = std::vector<std::pair<std::string, int>>;
+        REQUIRE(g.EdgesInWeightRange("hub", 3, 7) == Edges{{"a", 3}, {"b", 3}, {"c", 5}, {"c", 7}});
+        REQUIRE(g.EdgesInWeightRange("hub", 7, 3).empty());
+      }
+      THEN("MinWeight and MaxWeight look at a single pair") {
+        REQUIRE(g.MinWeight("hub", "c") == 5);
+        REQUIRE(g.MaxWeight("hub", "c") == 7);
+        REQUIRE(g.MinWeight("hub", "hub") == std::nullopt);
+      }
+      WHEN("Edges are erased and nodes deleted or merged") {
+        g.erase("hub", "d", 1);
+        g.DeleteNode("b");
+        g.MergeReplace("a", "c");
+        THEN("The queries reflect the changes") {
+          using Edges = std::vector<std::pair<std::string, int>>;
+          REQUIRE(g.TopKEdges("hub", 10) == Edges{{"c", 3}, {"c", 5}, {"c", 7}, {"c", 9}});
+          REQUIRE(g.EdgesInWeightRange("hub", 0, 4) == Edges{{"c", 3}});
+          REQUIRE(g.MaxWeight("hub", "c") == 9);
+        }
+      }
+    }
+  }
+}
+
+namespace {
+
+// Edge count the slow way, for checking the counters against
+template <typename N, typename E>
+std::size_t CountByIterating(gdwg::Graph<N, E>& g) {
+  return static_cast<std::size_t>(std::distance(g.begin(), g.end()));
+}
+
+}  // namespace
+
+SCENARIO("Size, edge and degree counters") {
+  GIVEN("A graph with parallel edges and a self loop") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "c", 1);
+    g.InsertEdge("d", "a", 1);
+    g.InsertEdge("a", "b", 1);
+    THEN("The counters match the graph") {
+      REQUIRE(g.size() == 4);
+      REQUIRE_FALSE(g.empty());
+      REQUIRE(g.NumEdges() == 6);
+      REQUIRE(g.NumEdges() == CountByIterating(g));
+      REQUIRE(g.OutDegree("a") == 3);
+      REQUIRE(g.OutDegree("c") == 1);
+      REQUIRE(g.DegreeHistogram() == std::map<std::size_t, std::size_t>{{1, 3}, {3, 1}});
+      REQUIRE_THROWS_WITH(g.OutDegree("z"),
+                          "Cannot call Graph::OutDegree if src doesn't exist in the graph");
+    }
+    WHEN("An edge is erased") {
+      g.erase("a", "b", 2);
+      g.erase(g.find("b", "c", 1));
+      THEN("Both erase overloads are counted") {
+        REQUIRE(g.NumEdges() == 4);
+        REQUIRE(g.NumEdges() == CountByIterating(g));
+        REQUIRE(g.OutDegree("b") == 0);
+      }
+    }
+    WHEN("A node with edges in and out is deleted") {
+      g.DeleteNode("c");
+      THEN("Edges into it stop counting before they are cleaned up") {
+        REQUIRE(g.size() == 3);
+        REQUIRE(g.NumEdges() == 3);
+        REQUIRE(g.OutDegree("a") == 2);
+        REQUIRE(g.OutDegree("b") == 0);
+        REQUIRE(g.NumEdges() == CountByIterating(g));
+      }
+      AND_WHEN("Another node is deleted") {
+        g.DeleteNode("b");
+        REQUIRE(g.NumEdges() == 1);
+        REQUIRE(g.NumEdges() == CountByIterating(g));
+        REQUIRE(g.DegreeHistogram() == std::map<std::size_t, std::size_t>{{0, 1}, {1, 1}});
+      }
+    }
+    WHEN("Nodes are merged") {
+      g.MergeReplace("b", "c");
+      THEN("Duplicates created by the merge are not counted") {
+        REQUIRE(g.size() == 3);
+        REQUIRE(g.NumEdges() == CountByIterating(g));
+        REQUIRE(g.OutDegree("a") == 2);
+      }
+    }
+    WHEN("The graph is moved from and cleared") {
+      gdwg::Graph<std::string, int> moved{std::move(g)};
+      REQUIRE(moved.NumEdges() == 6);
+      REQUIRE(g.NumEdges() == 0);
+      moved.Clear();
+      REQUIRE(moved.empty());
+      REQUIRE(moved.NumEdges() == 0);
+    }
+  }
+}
+
+namespace {
+
+// Pretends every weight owns a kilobyte of heap
+struct Heavy {
+  int value;
+  std::size_t HeapUsage() const { return 1024; }
+  friend bool operator<(const Heavy& a, const Heavy& b) { return a.value < b.value; }
+  friend bool operator==(const Heavy& a, const Heavy& b) { return a.value == b.value; }
+};
+
+}  // namespace
+
+SCENARIO("Reporting memory usage") {
+  GIVEN("An empty graph") {
+    gdwg::Graph<std::string, int> g;
+    THEN("Only the graph object itself is counted") {
+      auto usage = g.MemoryUsage();
+      REQUIRE(usage.Total() == sizeof(g));
+      REQUIRE(usage.node_index == sizeof(g));
+    }
+  }
+  GIVEN("A graph with short and long node names") {
+    std::string long_name(200, 'x');
+    gdwg::Graph<std::string, int> g{"a", long_name};
+    auto before = g.MemoryUsage();
+    THEN("The long name's buffer is counted") {
+      REQUIRE(before.node_values >= 2 * sizeof(std::string) + 200);
+      REQUIRE(before.node_values < 2 * sizeof(std::string) + 400);
+      REQUIRE(before.edge_cells == 0);
+      REQUIRE(before.weights == 0);
+      REQUIRE(before.control_blocks > 0);
+    }
+    WHEN("Edges are added") {
+      g.InsertEdge("a", long_name, 1);
+      g.InsertEdge(long_name, "a", 2);
+      auto after = g.MemoryUsage();
+      THEN("Edge cells and weights grow") {
+        REQUIRE(after.weights == 2 * sizeof(int));
+        REQUIRE(after.edge_cells >= 2 * sizeof(std::weak_ptr<std::string>));
+        REQUIRE(after.node_values == before.node_values);
+        REQUIRE(after.indexes == 0);
+        REQUIRE(after.Total() > before.Total());
+      }
+      AND_WHEN("The weight index is enabled") {
+        g.EnableWeightIndex();
+        REQUIRE(g.MemoryUsage().indexes > after.indexes);
+        g.DisableWeightIndex();
+        REQUIRE(g.MemoryUsage().indexes == 0);
+      }
+    }
+  }
+  GIVEN("A graph whose weights report their own heap usage") {
+    gdwg::Graph<int, Heavy> g{1, 2};
+    g.InsertEdge(1, 2, Heavy{1});
+    g.InsertEdge(2, 1, Heavy{2});
+    THEN("The hook is used") { REQUIRE(g.MemoryUsage().weights == 2 * (sizeof(Heavy) + 1024)); }
+  }
+}
+
+namespace {
+
+using EdgeTuple = std::tuple<int, int, int>;
+
+std::vector<EdgeTuple> Walk(const gdwg::Graph<int, int>::EdgeRange& range) {
+  std::vector<EdgeTuple> edges;
+  for (const auto& [src, dst, w] : range) {
+    edges.emplace_back(src, dst, w);
+  }
+  return edges;
+}
+
+}  // namespace
+
+SCENARIO("Splitting the edges into ranges") {
+  GIVEN("An empty graph") {
+    gdwg::Graph<int, int> g;
+    THEN("Zero ranges throws and any other number gives empty ranges") {
+      REQUIRE_THROWS_WITH(g.EdgeRanges(0), "Cannot call Graph::EdgeRanges with zero ranges");
+      auto ranges = g.EdgeRanges(3);
+      REQUIRE(ranges.size() == 3);
+      for (const auto& range : ranges) {
+        REQUIRE(range.size() == 0);
+        REQUIRE(range.begin() == range.end());
+      }
+    }
+  }
+  GIVEN("A hub holding most of the edges, and nodes without edges in between") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 40; ++i) {
+      g.InsertNode(i);
+    }
+    std::vector<EdgeTuple> expected;
+    for (int w = 0; w < 100; ++w) {
+      g.InsertEdge(5, w % 40, w);
+      expected.emplace_back(5, w % 40, w);
+    }
+    for (int i = 20; i < 30; ++i) {
+      g.InsertEdge(i, 0, i);
+      expected.emplace_back(i, 0, i);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    WHEN("It is split into ranges") {
+      auto ranges = g.EdgeRanges(4);
+      THEN("Each range holds about a quarter of the edges") {
+        REQUIRE(ranges.size() == 4);
+        for (const auto& range : ranges) {
+          REQUIRE(range.size() >= 27);
+          REQUIRE(range.size() <= 28);
+          REQUIRE(Walk(range).size() == range.size());
+        }
+      }
+      THEN("Walking them from several threads visits every edge once") {
+        std::vector<std::vector<EdgeTuple>> found(ranges.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < ranges.size(); ++i) {
+          threads.emplace_back([&, i] { found[i] = Walk(ranges[i]); });
+        }
+        for (auto& thread : threads) {
+          thread.join();
+        }
+        std::vector<EdgeTuple> all;
+        for (const auto& part : found) {
+          all.insert(all.end(), part.begin(), part.end());
+        }
+        std::sort(all.begin(), all.end());
+        REQUIRE(all == expected);
+      }
+    }
+    WHEN("There are more ranges than edges") {
+      auto ranges = g.EdgeRanges(500);
+      std::size_t total = 0;
+      for (const auto& range : ranges) {
+        REQUIRE(range.size() <= 1);
+        total += Walk(range).size();
+      }
+      THEN("The spare ranges are empty") { REQUIRE(total == expected.size()); }
+    }
+    WHEN("A node some edges point to is deleted") {
+      g.DeleteNode(0);
+      std::size_t walked = 0;
+      std::size_t cells = 0;
+      for (const auto& range : g.EdgeRanges(3)) {
+        walked += Walk(range).size();
+        cells += range.size();
+      }
+      THEN("Its edges are skipped but left for the graph to clean up") {
+        REQUIRE(walked == g.NumEdges());
+        REQUIRE(cells > walked);
+      }
+    }
+  }
+}
+
+SCENARIO("Inserting a batch of edges") {
+  GIVEN("A graph with a weight index and a couple of edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c"};
+    g.EnableWeightIndex();
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 2);
+
+    WHEN("An unsorted batch with repeats and existing edges is inserted") {
+      auto inserted = g.InsertEdges({{"b", "c", 2},
+                                     {"c", "a", 3},
+                                     {"a", "c", 5},
+                                     {"a", "b", 1},
+                                     {"a", "c", 5},
+                                     {"a", "b", 4}});
+      THEN("Only the new edges are added") {
+        REQUIRE(inserted == 3);
+        REQUIRE(g.NumEdges() == 5);
+        REQUIRE(g.GetWeights("a", "b") == std::vector<int>{1, 4});
+        REQUIRE(g.GetWeights("a", "c") == std::vector<int>{5});
+        REQUIRE(g.IsConnected("c", "a"));
+        REQUIRE(g.MinWeight("a", "b") == 1);
+        REQUIRE(g.TopKEdges("a", 1) == std::vector<std::pair<std::string, int>>{{"b", 1}});
+      }
+    }
+
+    WHEN("A batch names a node that doesn't exist") {
+      THEN("It throws without adding anything") {
+        REQUIRE_THROWS_WITH(
+            g.InsertEdges({{"a", "c", 7}, {"c", "z", 1}}),
+            "Cannot call Graph::InsertEdges when either src or dst node does not exist");
+        REQUIRE(g.NumEdges() == 2);
+        REQUIRE_FALSE(g.IsConnected("a", "c"));
+      }
+    }
+
+    WHEN("The batch is empty") {
+      THEN("Nothing changes") {
+        REQUIRE(g.InsertEdges({}) == 0);
+        REQUIRE(g.NumEdges() == 2);
+      }
+    }
+  }
+
+  GIVEN("A graph keeping a topological order") {
+    gdwg::Graph<int, int> g{1, 2, 3};
+    g.EnableTopologicalOrder();
+    THEN("A batch that closes a cycle throws") {
+      REQUIRE(g.InsertEdges({{1, 2, 0}, {2, 3, 0}}) == 2);
+      REQUIRE_THROWS_WITH(g.InsertEdges({{3, 1, 0}}),
+                          "Cannot call Graph::InsertEdge when the edge would create a cycle");
+    }
+  }
+}
+
+SCENARIO("Extracting an induced subgraph") {
+  GIVEN("A graph with edges into, out of and within the part to extract") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "a", 2);
+    g.InsertEdge("b", "b", 3);
+    g.InsertEdge("b", "c", 4);
+    g.InsertEdge("c", "a", 5);
+    g.InsertEdge("d", "a", 6);
+    g.DeleteNode("d");
+
+    WHEN("a, b and c are extracted, out of order and repeated") {
+      auto sub = g.InducedSubgraph({"c", "a", "b", "a"});
+      THEN("It matches copying the graph and deleting the rest") {
+        REQUIRE(sub == g);
+        REQUIRE(sub.NumEdges() == 5);
+      }
+    }
+
+    WHEN("a and b are extracted") {
+      auto sub = g.InducedSubgraph({"a", "b"});
+      THEN("Only the edges between them come along") {
+        REQUIRE(sub.GetNodes() == std::vector<std::string>{"a", "b"});
+        REQUIRE(sub.NumEdges() == 3);
+        REQUIRE(sub.GetWeights("b", "b") == std::vector<int>{3});
+        REQUIRE(sub.OutDegree("b") == 2);
+      }
+      THEN("Changing it leaves the original alone") {
+        sub.InsertEdge("a", "a", 9);
+        sub.DeleteNode("b");
+        REQUIRE(g.NumEdges() == 5);
+        REQUIRE(g.IsConnected("a", "b"));
+        REQUIRE_FALSE(g.IsConnected("a", "a"));
+      }
+    }
+
+    WHEN("A node is unknown") {
+      THEN("It throws") {
+        REQUIRE_THROWS_WITH(
+            g.InducedSubgraph({"a", "z"}),
+            "Cannot call Graph::InducedSubgraph with a node that doesn't exist in the graph");
+      }
+    }
+  }
+
+  GIVEN("A DAG with a topological order and weight index") {
+    gdwg::Graph<int, int> g{1, 2, 3, 4};
+    g.EnableTopologicalOrder();
+    g.EnableWeightIndex();
+    g.InsertEdge(3, 1, 2);
+    g.InsertEdge(1, 2, 7);
+    g.InsertEdge(3, 4, 1);
+    auto sub = g.InducedSubgraph({1, 2, 3});
+    THEN("Both are kept up to date on the subgraph") {
+      REQUIRE(sub.MaintainsTopologicalOrder());
+      REQUIRE(sub.TopologicalOrder() == std::vector<int>{3, 1, 2});
+      REQUIRE(sub.HasWeightIndex());
+      REQUIRE(sub.TopKEdges(3, 5) == std::vector<std::pair<int, int>>{{1, 2}});
+      REQUIRE_THROWS(sub.InsertEdge(2, 3, 0));
+    }
+  }
+}
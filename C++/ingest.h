@@ -0,0 +1,311 @@
+#ifndef ASSIGNMENTS_DG_INGEST_H_
+#define ASSIGNMENTS_DG_INGEST_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/bounded_queue.h"
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+// Where one pipeline stage spent its time
+struct StageStats {
+  // Doing the stage's own work. The parse stage runs on the caller's thread, so for it this is
+  // everything between construction and Finish that wasn't spent blocked.
+  std::chrono::nanoseconds busy{0};
+  // Waiting for room in the next stage's queue, i.e. backpressure from downstream
+  std::chrono::nanoseconds blocked{0};
+  // Waiting for the previous stage to hand over a batch
+  std::chrono::nanoseconds starved{0};
+  // Hand-offs that found the next queue full
+  std::size_t stalls = 0;
+  std::size_t batches = 0;
+};
+
+struct IngestStats {
+  StageStats parse;
+  // Summed over the dedupe workers
+  StageStats dedupe;
+  StageStats apply;
+  std::size_t records = 0;
+  // Records repeated within a batch or already in the graph
+  std::size_t duplicates = 0;
+  std::size_t inserted = 0;
+  std::chrono::nanoseconds wall{0};
+};
+
+struct IngestOptions {
+  // Records per batch handed between stages
+  std::size_t batch_size = 4096;
+  // Batches each queue holds before the stage feeding it blocks
+  std::size_t queue_capacity = 16;
+  std::size_t dedupe_workers = 2;
+};
+
+// Loads edges into a Graph as a three-stage pipeline, so parsing overlaps with insertion:
+//  * parse, on the caller's thread: Push or Load records, which are cut into batches
+//  * dedupe, on dedupe_workers threads: sort each batch, drop repeats, and list its nodes
+//  * apply, on one thread: insert the batch's nodes, then its edges with one InsertEdges call
+// Stages hand batches over through bounded lock-free queues, so a slow stage holds up the one
+// before it instead of letting memory grow; the stats say which stage that was.
+// The graph belongs to the apply thread until Finish returns and must not be touched before.
+template <typename N, typename E>
+class IngestPipeline {
+ public:
+  explicit IngestPipeline(gdwg::Graph<N, E>& g, IngestOptions options = {});
+  IngestPipeline(const IngestPipeline&) = delete;
+  IngestPipeline& operator=(const IngestPipeline&) = delete;
+  // Finishes the load if Finish wasn't called, discarding any error
+  ~IngestPipeline();
+
+  void Push(N src, N dst, E w);
+  // Pushes one "src dst weight" record per line, read with operator>>. Blank lines are skipped.
+  void Load(std::istream& in);
+
+  // Flushes the last batch, waits for every stage to drain and returns the stats. Rethrows
+  // the first error raised while applying a batch; batches after it are dropped.
+  IngestStats Finish();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Batch {
+    std::vector<std::tuple<N, N, E>> edges;
+    std::vector<N> nodes;
+    // Repeats dropped by the dedupe stage
+    std::size_t duplicates = 0;
+  };
+
+  // Spins briefly, then sleeps, until ready() holds, and returns how long that took
+  template <typename Ready>
+  static std::chrono::nanoseconds WaitUntil(const Ready& ready) {
+    auto start = Clock::now();
+    for (std::size_t spins = 0; !ready(); ++spins) {
+      if (spins < 64) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds{50});
+      }
+    }
+    return Clock::now() - start;
+  }
+
+  static void Give(BoundedQueue<Batch>& queue, Batch& batch, StageStats& stats) {
+    if (!queue.TryPush(batch)) {
+      ++stats.stalls;
+      stats.blocked += WaitUntil([&] { return queue.TryPush(batch); });
+    }
+  }
+
+  // Returns false once closed() holds and the queue is drained
+  template <typename Closed>
+  static bool Take(BoundedQueue<Batch>& queue,
+                   Batch& batch,
+                   const Closed& closed,
+                   StageStats& stats) {
+    if (queue.TryPop(batch)) {
+      return true;
+    }
+    bool taken = false;
+    stats.starved += WaitUntil([&] {
+      if (queue.TryPop(batch)) {
+        return taken = true;
+      }
+      // Everything upstream was queued before closed() became true, so one more look settles it
+      if (closed()) {
+        taken = queue.TryPop(batch);
+        return true;
+      }
+      return false;
+    });
+    return taken;
+  }
+
+  void Flush();
+  void DedupeLoop();
+  void ApplyLoop();
+
+  gdwg::Graph<N, E>& g_;
+  IngestOptions options_;
+  BoundedQueue<Batch> to_dedupe_;
+  BoundedQueue<Batch> to_apply_;
+  Batch pending_;
+  Clock::time_point start_;
+  bool finished_ = false;
+
+  std::atomic<bool> parsed_{false};
+  std::atomic<std::size_t> deduping_;
+  std::vector<std::thread> workers_;
+  std::thread applier_;
+
+  // Workers add their dedupe stats here as they exit; the rest is only touched by its stage
+  std::mutex stats_mutex_;
+  IngestStats stats_;
+  std::exception_ptr error_;
+};
+
+template <typename N, typename E>
+gdwg::IngestPipeline<N, E>::IngestPipeline(gdwg::Graph<N, E>& g, IngestOptions options)
+  : g_{g}, options_{options}, to_dedupe_{options.queue_capacity},
+    to_apply_{options.queue_capacity}, start_{Clock::now()}, deduping_{options.dedupe_workers} {
+  if (options_.batch_size == 0 || options_.dedupe_workers == 0) {
+    throw std::invalid_argument{
+        "Cannot construct IngestPipeline with a zero batch size or no dedupe workers"};
+  }
+  pending_.edges.reserve(options_.batch_size);
+  for (std::size_t i = 0; i < options_.dedupe_workers; ++i) {
+    workers_.emplace_back([this] { DedupeLoop(); });
+  }
+  applier_ = std::thread{[this] { ApplyLoop(); }};
+}
+
+template <typename N, typename E>
+gdwg::IngestPipeline<N, E>::~IngestPipeline() {
+  if (!finished_) {
+    try {
+      Finish();
+    } catch (...) {
+    }
+  }
+}
+
+template <typename N, typename E>
+void gdwg::IngestPipeline<N, E>::Push(N src, N dst, E w) {
+  if (finished_) {
+    throw std::runtime_error{"Cannot call IngestPipeline::Push after Finish"};
+  }
+  pending_.edges.emplace_back(std::move(src), std::move(dst), std::move(w));
+  ++stats_.records;
+  if (pending_.edges.size() == options_.batch_size) {
+    Flush();
+  }
+}
+
+template <typename N, typename E>
+void gdwg::IngestPipeline<N, E>::Load(std::istream& in) {
+  std::size_t number = 0;
+  for (std::string line; std::getline(in, line);) {
+    ++number;
+    std::istringstream record{line};
+    if (!(record >> std::ws) || record.eof()) {
+      continue;
+    }
+    N src;
+    N dst;
+    E w;
+    if (!(record >> src >> dst >> w) || !(record >> std::ws).eof()) {
+      throw std::invalid_argument{"Cannot call IngestPipeline::Load with a malformed line " +
+                                  std::to_string(number)};
+    }
+    Push(std::move(src), std::move(dst), std::move(w));
+  }
+}
+
+template <typename N, typename E>
+gdwg::IngestStats gdwg::IngestPipeline<N, E>::Finish() {
+  if (finished_) {
+    throw std::runtime_error{"Cannot call IngestPipeline::Finish more than once"};
+  }
+  finished_ = true;
+  if (!pending_.edges.empty()) {
+    Flush();
+  }
+  stats_.parse.busy = Clock::now() - start_ - stats_.parse.blocked;
+  parsed_.store(true, std::memory_order_release);
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  applier_.join();
+  stats_.wall = Clock::now() - start_;
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  return stats_;
+}
+
+template <typename N, typename E>
+void gdwg::IngestPipeline<N, E>::Flush() {
+  ++stats_.parse.batches;
+  Give(to_dedupe_, pending_, stats_.parse);
+  pending_ = Batch{};
+  pending_.edges.reserve(options_.batch_size);
+}
+
+template <typename N, typename E>
+void gdwg::IngestPipeline<N, E>::DedupeLoop() {
+  StageStats stats;
+  auto parsed = [this] { return parsed_.load(std::memory_order_acquire); };
+  for (Batch batch; Take(to_dedupe_, batch, parsed, stats);) {
+    auto start = Clock::now();
+    auto& edges = batch.edges;
+    std::sort(edges.begin(), edges.end());
+    auto size = edges.size();
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    batch.duplicates = size - edges.size();
+
+    batch.nodes.clear();
+    batch.nodes.reserve(2 * edges.size());
+    for (const auto& edge : edges) {
+      batch.nodes.push_back(std::get<0>(edge));
+      batch.nodes.push_back(std::get<1>(edge));
+    }
+    std::sort(batch.nodes.begin(), batch.nodes.end());
+    batch.nodes.erase(std::unique(batch.nodes.begin(), batch.nodes.end()), batch.nodes.end());
+    ++stats.batches;
+    stats.busy += Clock::now() - start;
+    Give(to_apply_, batch, stats);
+  }
+
+  std::lock_guard<std::mutex> lock{stats_mutex_};
+  auto& total = stats_.dedupe;
+  total.busy += stats.busy;
+  total.blocked += stats.blocked;
+  total.starved += stats.starved;
+  total.stalls += stats.stalls;
+  total.batches += stats.batches;
+  // Last one out tells the apply stage nothing more is coming
+  deduping_.fetch_sub(1, std::memory_order_release);
+}
+
+template <typename N, typename E>
+void gdwg::IngestPipeline<N, E>::ApplyLoop() {
+  auto& stats = stats_.apply;
+  auto deduped = [this] { return deduping_.load(std::memory_order_acquire) == 0; };
+  for (Batch batch; Take(to_apply_, batch, deduped, stats);) {
+    // Keep draining after an error so the earlier stages never block on a full queue
+    if (error_) {
+      continue;
+    }
+    auto start = Clock::now();
+    try {
+      for (const auto& node : batch.nodes) {
+        g_.InsertNode(node);
+      }
+      auto size = batch.edges.size();
+      auto inserted = g_.InsertEdges(std::move(batch.edges));
+      stats_.inserted += inserted;
+      stats_.duplicates += batch.duplicates + size - inserted;
+    } catch (...) {
+      error_ = std::current_exception();
+    }
+    ++stats.batches;
+    stats.busy += Clock::now() - start;
+  }
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_INGEST_H_
@@ -0,0 +1,205 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The queue is tested on its own first, since the pipeline's correctness rests on it:
+  * BoundedQueue
+    - capacity rounds up to a power of two; pushes fail when full, pops when empty
+    - values come out in the order they went in, including after wrapping around
+    - with several producers and consumers, every value comes out exactly once
+
+  The pipeline is then checked against the single-threaded load it replaces: the graph it
+  builds must equal one built with InsertNode/InsertEdge from the same records.
+  * IngestPipeline
+    - same graph as a one-thread load, with repeats both inside and across batches, and
+      with tiny batches and queues so every hand-off contends
+    - record, batch, insert and duplicate counts add up
+    - Load parses records line by line, skips blank lines and reports a malformed line
+    - invalid options, Push after Finish and a second Finish throw
+
+*/
+
+#include "assignments/dg/ingest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/bounded_queue.h"
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+SCENARIO("A bounded lock-free queue") {
+  GIVEN("A queue asked for 3 slots") {
+    gdwg::BoundedQueue<int> queue{3};
+    THEN("It holds 4, in order, and reports full and empty") {
+      REQUIRE(queue.Capacity() == 4);
+      for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+          int value = round * 10 + i;
+          REQUIRE(queue.TryPush(value));
+        }
+        int extra = 99;
+        REQUIRE_FALSE(queue.TryPush(extra));
+        for (int i = 0; i < 4; ++i) {
+          int value = -1;
+          REQUIRE(queue.TryPop(value));
+          REQUIRE(value == round * 10 + i);
+        }
+        int value = -1;
+        REQUIRE_FALSE(queue.TryPop(value));
+      }
+    }
+  }
+
+  GIVEN("Four producers and four consumers sharing a small queue") {
+    constexpr int kPerProducer = 50000;
+    gdwg::BoundedQueue<int> queue{8};
+    std::vector<std::vector<int>> received(4);
+    std::atomic<int> remaining{4 * kPerProducer};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < 4; ++p) {
+      threads.emplace_back([&queue, p] {
+        for (int i = 0; i < kPerProducer; ++i) {
+          int value = p * kPerProducer + i;
+          while (!queue.TryPush(value)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (int c = 0; c < 4; ++c) {
+      threads.emplace_back([&, c] {
+        while (remaining.load() > 0) {
+          int value;
+          if (queue.TryPop(value)) {
+            received[c].push_back(value);
+            remaining.fetch_sub(1);
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    THEN("Every value is received exactly once") {
+      std::vector<int> all;
+      for (const auto& part : received) {
+        all.insert(all.end(), part.begin(), part.end());
+      }
+      std::sort(all.begin(), all.end());
+      REQUIRE(all.size() == 4 * kPerProducer);
+      REQUIRE(std::adjacent_find(all.begin(), all.end()) == all.end());
+      REQUIRE(all.front() == 0);
+      REQUIRE(all.back() == 4 * kPerProducer - 1);
+    }
+  }
+}
+
+namespace {
+
+// Skewed records over 500 nodes, with plenty of repeats
+std::vector<std::tuple<int, int, int>> Records(std::size_t count) {
+  std::vector<std::tuple<int, int, int>> records;
+  unsigned state = 12345;
+  auto next = [&state] {
+    state = state * 1103515245u + 12345u;
+    return static_cast<int>((state >> 8) % 500);
+  };
+  for (std::size_t i = 0; i < count; ++i) {
+    auto src = next();
+    auto dst = next() / 4;
+    records.emplace_back(src, dst, next() % 3);
+  }
+  return records;
+}
+
+}  // namespace
+
+SCENARIO("Ingesting edges through the pipeline") {
+  GIVEN("Records loaded one at a time on one thread") {
+    auto records = Records(20000);
+    gdwg::Graph<int, int> expected;
+    for (const auto& [src, dst, w] : records) {
+      expected.InsertNode(src);
+      expected.InsertNode(dst);
+      expected.InsertEdge(src, dst, w);
+    }
+
+    for (auto options : {gdwg::IngestOptions{}, gdwg::IngestOptions{7, 1, 3}}) {
+      WHEN("The same records go through a pipeline") {
+        gdwg::Graph<int, int> g;
+        gdwg::IngestPipeline<int, int> pipeline{g, options};
+        for (const auto& [src, dst, w] : records) {
+          pipeline.Push(src, dst, w);
+        }
+        auto stats = pipeline.Finish();
+        THEN("The graph matches and the counts add up") {
+          REQUIRE(g == expected);
+          REQUIRE(stats.records == records.size());
+          REQUIRE(stats.inserted == expected.NumEdges());
+          REQUIRE(stats.inserted + stats.duplicates == stats.records);
+          auto batches = (records.size() + options.batch_size - 1) / options.batch_size;
+          REQUIRE(stats.parse.batches == batches);
+          REQUIRE(stats.dedupe.batches == batches);
+          REQUIRE(stats.apply.batches == batches);
+          REQUIRE(stats.wall >= stats.apply.busy);
+        }
+      }
+    }
+  }
+
+  GIVEN("Records as text") {
+    gdwg::Graph<std::string, double> g;
+    gdwg::IngestPipeline<std::string, double> pipeline{g, gdwg::IngestOptions{2, 2, 1}};
+    WHEN("Every line is well formed") {
+      std::istringstream in{"a b 1.5\n\n  b c 2\na b 1.5\nc a -1\n"};
+      pipeline.Load(in);
+      auto stats = pipeline.Finish();
+      THEN("Each distinct record becomes an edge") {
+        REQUIRE(stats.records == 4);
+        REQUIRE(stats.inserted == 3);
+        REQUIRE(g.GetNodes() == std::vector<std::string>{"a", "b", "c"});
+        REQUIRE(g.GetWeights("a", "b") == std::vector<double>{1.5});
+        REQUIRE(g.IsConnected("c", "a"));
+      }
+    }
+    WHEN("A line has a missing or extra field") {
+      std::istringstream missing{"a b 1\nb c\n"};
+      std::istringstream extra{"a b 1 2\n"};
+      THEN("The line is reported") {
+        REQUIRE_THROWS_WITH(pipeline.Load(missing),
+                            "Cannot call IngestPipeline::Load with a malformed line 2");
+        REQUIRE_THROWS_WITH(pipeline.Load(extra),
+                            "Cannot call IngestPipeline::Load with a malformed line 1");
+      }
+    }
+  }
+
+  GIVEN("A pipeline") {
+    gdwg::Graph<int, int> g;
+    THEN("Bad options are refused") {
+      REQUIRE_THROWS_WITH(
+          (gdwg::IngestPipeline<int, int>{g, gdwg::IngestOptions{0, 4, 1}}),
+          "Cannot construct IngestPipeline with a zero batch size or no dedupe workers");
+      REQUIRE_THROWS_WITH(
+          (gdwg::IngestPipeline<int, int>{g, gdwg::IngestOptions{4, 4, 0}}),
+          "Cannot construct IngestPipeline with a zero batch size or no dedupe workers");
+    }
+    THEN("It can't be used once finished") {
+      gdwg::IngestPipeline<int, int> pipeline{g};
+      pipeline.Push(1, 2, 3);
+      pipeline.Finish();
+      REQUIRE(g.IsConnected(1, 2));
+      REQUIRE_THROWS_WITH(pipeline.Push(2, 3, 4), "Cannot call IngestPipeline::Push after Finish");
+      REQUIRE_THROWS_WITH(pipeline.Finish(), "Cannot call IngestPipeline::Finish more than once");
+    }
+  }
+}
@@ -0,0 +1,194 @@
+#ifndef ASSIGNMENTS_DG_INTERSECT_H_
+#define ASSIGNMENTS_DG_INTERSECT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace gdwg {
+namespace detail {
+
+// Intersection of two strictly increasing id runs. Runs of similar length use a blocked SIMD
+// merge (AVX2 or SSE2, whichever the build targets, else scalar); when one run is much
+// shorter each of its ids is found in the other by galloping search instead.
+
+// Beyond this length ratio galloping beats a linear merge
+constexpr std::size_t kGallopRatio = 32;
+
+template <bool Write>
+inline std::size_t ScalarIntersect(const std::uint32_t* a,
+                                   const std::uint32_t* a_end,
+                                   const std::uint32_t* b,
+                                   const std::uint32_t* b_end,
+                                   std::uint32_t* out) {
+  std::size_t count = 0;
+  while (a != a_end && b != b_end) {
+    if (*a < *b) {
+      ++a;
+    } else if (*b < *a) {
+      ++b;
+    } else {
+      if constexpr (Write) {
+        out[count] = *a;
+      }
+      ++count;
+      ++a;
+      ++b;
+    }
+  }
+  return count;
+}
+
+// small must be the shorter run
+template <bool Write>
+inline std::size_t GallopIntersect(const std::uint32_t* small,
+                                   const std::uint32_t* small_end,
+                                   const std::uint32_t* large,
+                                   const std::uint32_t* large_end,
+                                   std::uint32_t* out) {
+  std::size_t count = 0;
+  for (; small != small_end && large != large_end; ++small) {
+    // Double the step until we pass the target, then binary search the last step
+    std::size_t step = 1;
+    const auto* low = large;
+    while (low + step < large_end && low[step] < *small) {
+      low += step;
+      step *= 2;
+    }
+    const auto* high = low + step < large_end ? low + step + 1 : large_end;
+    while (low < high) {
+      const auto* mid = low + (high - low) / 2;
+      if (*mid < *small) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    large = low;
+    if (large != large_end && *large == *small) {
+      if constexpr (Write) {
+        out[count] = *small;
+      }
+      ++count;
+      ++large;
+    }
+  }
+  return count;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+constexpr std::ptrdiff_t kBlock = 8;
+
+// Bit i is set when a[i] appears anywhere in b[0, kBlock)
+inline unsigned BlockMatch(const std::uint32_t* a, const std::uint32_t* b) {
+  const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+  auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+  auto match = _mm256_cmpeq_epi32(va, vb);
+  for (int i = 1; i < kBlock; ++i) {
+    vb = _mm256_permutevar8x32_epi32(vb, rotate);
+    match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+  }
+  return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+}
+#else
+constexpr std::ptrdiff_t kBlock = 4;
+
+// Bit i is set when a[i] appears anywhere in b[0, kBlock)
+inline unsigned BlockMatch(const std::uint32_t* a, const std::uint32_t* b) {
+  auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+  auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+  auto match = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                   _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+      _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                   _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+  return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(match)));
+}
+#endif
+
+// Compares a block of a against a block of b, then drops whichever block has the smaller
+// maximum (both when they tie). Runs are strictly increasing, so an id of a cannot match in a
+// later block of b once its own block has moved on, and nothing is counted twice.
+template <bool Write>
+inline std::size_t VectorIntersect(const std::uint32_t* a,
+                                   const std::uint32_t* a_end,
+                                   const std::uint32_t* b,
+                                   const std::uint32_t* b_end,
+                                   std::uint32_t* out) {
+  std::size_t count = 0;
+  while (a_end - a >= kBlock && b_end - b >= kBlock) {
+    auto mask = BlockMatch(a, b);
+    if constexpr (Write) {
+      for (; mask != 0; mask &= mask - 1) {
+        out[count++] = a[__builtin_ctz(mask)];
+      }
+    } else {
+      count += static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    auto a_max = a[kBlock - 1];
+    auto b_max = b[kBlock - 1];
+    if (a_max <= b_max) {
+      a += kBlock;
+    }
+    if (b_max <= a_max) {
+      b += kBlock;
+    }
+  }
+  return count + ScalarIntersect<Write>(a, a_end, b, b_end, Write ? out + count : nullptr);
+}
+#else
+template <bool Write>
+inline std::size_t VectorIntersect(const std::uint32_t* a,
+                                   const std::uint32_t* a_end,
+                                   const std::uint32_t* b,
+                                   const std::uint32_t* b_end,
+                                   std::uint32_t* out) {
+  return ScalarIntersect<Write>(a, a_end, b, b_end, out);
+}
+#endif
+
+template <bool Write>
+inline std::size_t IntersectRuns(const std::uint32_t* a,
+                                 const std::uint32_t* a_end,
+                                 const std::uint32_t* b,
+                                 const std::uint32_t* b_end,
+                                 std::uint32_t* out) {
+  auto a_size = static_cast<std::size_t>(a_end - a);
+  auto b_size = static_cast<std::size_t>(b_end - b);
+  if (a_size * kGallopRatio < b_size) {
+    return GallopIntersect<Write>(a, a_end, b, b_end, out);
+  }
+  if (b_size * kGallopRatio < a_size) {
+    return GallopIntersect<Write>(b, b_end, a, a_end, out);
+  }
+  return VectorIntersect<Write>(a, a_end, b, b_end, out);
+}
+
+// Size of the intersection
+inline std::size_t IntersectCount(const std::uint32_t* a,
+                                  const std::uint32_t* a_end,
+                                  const std::uint32_t* b,
+                                  const std::uint32_t* b_end) {
+  return IntersectRuns<false>(a, a_end, b, b_end, nullptr);
+}
+
+// Writes the common ids to out, which needs room for the shorter run, and returns how many
+inline std::size_t Intersect(const std::uint32_t* a,
+                             const std::uint32_t* a_end,
+                             const std::uint32_t* b,
+                             const std::uint32_t* b_end,
+                             std::uint32_t* out) {
+  return IntersectRuns<true>(a, a_end, b, b_end, out);
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_INTERSECT_H_
@@ -0,0 +1,235 @@
+#ifndef ASSIGNMENTS_DG_JOURNAL_H_
+#define ASSIGNMENTS_DG_JOURNAL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace gdwg {
+
+// Binary encoding of node and edge values, used by Graph snapshots and the journal.
+// Trivially copyable types are stored byte for byte in native byte order, so files are only
+// read back on the platform that wrote them. Strings are stored as a length and their
+// characters. Other types need a specialisation with the same two members.
+template <typename T, typename = void>
+struct Codec {};
+
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+  static void Encode(std::string& out, const T& val) {
+    out.append(reinterpret_cast<const char*>(&val), sizeof(T));
+  }
+  // Advances in past val, or returns false if [in, end) is too short
+  static bool Decode(const char*& in, const char* end, T& val) {
+    if (static_cast<std::size_t>(end - in) < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&val, in, sizeof(T));
+    in += sizeof(T);
+    return true;
+  }
+};
+
+template <typename C, typename T, typename A>
+struct Codec<std::basic_string<C, T, A>, void> {
+  static void Encode(std::string& out, const std::basic_string<C, T, A>& val) {
+    Codec<std::uint64_t>::Encode(out, val.size());
+    out.append(reinterpret_cast<const char*>(val.data()), val.size() * sizeof(C));
+  }
+  static bool Decode(const char*& in, const char* end, std::basic_string<C, T, A>& val) {
+    std::uint64_t size;
+    if (!Codec<std::uint64_t>::Decode(in, end, size) ||
+        static_cast<std::uint64_t>(end - in) / sizeof(C) < size) {
+      return false;
+    }
+    val.resize(static_cast<std::size_t>(size));
+    std::memcpy(&val[0], in, val.size() * sizeof(C));
+    in += val.size() * sizeof(C);
+    return true;
+  }
+};
+
+template <typename T, typename = void>
+struct IsEncodable : std::false_type {};
+
+template <typename T>
+struct IsEncodable<T, std::void_t<decltype(&Codec<T>::Encode)>> : std::true_type {};
+
+// The Graph mutations a journal records, with their fields in argument order
+enum class JournalOp : std::uint8_t {
+  kInsertNode = 1,  // val
+  kInsertEdge,      // src, dst, w
+  kErase,           // src, dst, w
+  kDeleteNode,      // val
+  kReplace,         // oldData, newData
+  kMergeReplace,    // oldData, newData
+  kClear,
+};
+
+namespace detail {
+
+// Each group of records is written as its byte length and checksum, then the records
+constexpr std::size_t kGroupHeader = 2 * sizeof(std::uint32_t);
+// Most of a group read from the log at once, before its length can be trusted
+constexpr std::size_t kReadChunk = 1 << 16;
+
+// FNV-1a, enough to spot a torn or garbled group
+inline std::uint32_t Checksum(const char* data, std::size_t size) noexcept {
+  std::uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace detail
+
+// Append-only write-ahead log of Graph mutations. Attach it with Graph::SetJournal and every
+// successful mutation is appended as a compact binary record; failed or no-op calls are not
+// recorded. Records are buffered and written, then flushed, a group at a time, so a
+// checkpoint costs the size of the changes since the last Graph::Snapshot rather than the
+// whole graph. Graph::Recover replays a snapshot and the log written after it.
+//
+// A crash can tear the last group; recovery detects that with the group's checksum and stops
+// before it, so at most the last unflushed group is lost. Call Flush to bound that.
+class Journal {
+ public:
+  explicit Journal(std::ostream& log, std::size_t group_size = 64)
+    : log_{log}, group_size_{group_size == 0 ? 1 : group_size} {}
+
+  Journal(const Journal&) = delete;
+  Journal& operator=(const Journal&) = delete;
+
+  // Writes out the last partial group; errors are lost, so call Flush to see them
+  ~Journal() {
+    if (pending_ > 0) {
+      WriteGroup();
+    }
+  }
+
+  template <typename... Fields>
+  void Record(JournalOp op, const Fields&... fields) {
+    buffer_.push_back(static_cast<char>(op));
+    (Codec<Fields>::Encode(buffer_, fields), ...);
+    ++pending_;
+    ++records_;
+    if (pending_ >= group_size_) {
+      WriteGroup();
+    }
+  }
+
+  // Writes out any partial group and flushes the stream
+  void Flush() {
+    if (pending_ > 0) {
+      WriteGroup();
+    }
+    if (failed_) {
+      throw std::runtime_error{"Cannot call Journal::Flush after the log stream failed"};
+    }
+  }
+
+  std::size_t Records() const noexcept { return records_; }
+  std::size_t Groups() const noexcept { return groups_; }
+  // Bytes handed to the log stream so far, including group headers
+  std::size_t Bytes() const noexcept { return bytes_; }
+
+ private:
+  void WriteGroup() {
+    std::string header;
+    Codec<std::uint32_t>::Encode(header, static_cast<std::uint32_t>(buffer_.size()));
+    Codec<std::uint32_t>::Encode(header, detail::Checksum(buffer_.data(), buffer_.size()));
+    log_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    log_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    log_.flush();
+    failed_ = failed_ || !log_;
+    bytes_ += header.size() + buffer_.size();
+    ++groups_;
+    buffer_.clear();
+    pending_ = 0;
+  }
+
+  std::ostream& log_;
+  std::size_t group_size_;
+  std::string buffer_;
+  std::size_t pending_ = 0;
+  std::size_t records_ = 0;
+  std::size_t groups_ = 0;
+  std::size_t bytes_ = 0;
+  bool failed_ = false;
+};
+
+// Reads back the records of a Journal's log, one intact group at a time
+class JournalReader {
+ public:
+  explicit JournalReader(std::istream& log) : log_{log} {}
+
+  // Moves to the next record. Returns false at the end of the log, or at a torn or corrupt
+  // group, which is treated as the end.
+  bool Next(JournalOp& op) {
+    while (pos_ == group_.size()) {
+      if (ended_ || !ReadGroup()) {
+        ended_ = true;
+        return false;
+      }
+    }
+    op = static_cast<JournalOp>(group_[pos_++]);
+    return true;
+  }
+
+  // Reads the current record's next field
+  template <typename T>
+  void Read(T& val) {
+    const char* in = group_.data() + pos_;
+    if (!Codec<T>::Decode(in, group_.data() + group_.size(), val)) {
+      throw std::runtime_error{"Cannot call JournalReader::Read past the end of a record"};
+    }
+    pos_ = static_cast<std::size_t>(in - group_.data());
+  }
+
+ private:
+  bool ReadGroup() {
+    char header[detail::kGroupHeader];
+    if (!log_.read(header, sizeof(header))) {
+      return false;
+    }
+    const char* in = header;
+    const char* end = header + sizeof(header);
+    std::uint32_t size;
+    std::uint32_t checksum;
+    Codec<std::uint32_t>::Decode(in, end, size);
+    Codec<std::uint32_t>::Decode(in, end, checksum);
+    // size isn't checked until the group's checksum is, so the group grows only as its bytes
+    // arrive: a corrupt header can't allocate more than is left in the log
+    group_.clear();
+    pos_ = 0;
+    while (group_.size() < size) {
+      auto start = group_.size();
+      group_.resize(start + std::min<std::size_t>(size - start, detail::kReadChunk));
+      if (!log_.read(&group_[start], static_cast<std::streamsize>(group_.size() - start))) {
+        group_.clear();
+        return false;
+      }
+    }
+    if (detail::Checksum(group_.data(), size) != checksum) {
+      group_.clear();
+      return false;
+    }
+    return true;
+  }
+
+  std::istream& log_;
+  std::string group_;
+  std::size_t pos_ = 0;
+  // Nothing after a bad group is trusted
+  bool ended_ = false;
+};
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_JOURNAL_H_
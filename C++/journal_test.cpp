@@ -0,0 +1,236 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Recovery is checked the way it is used: take a snapshot, keep mutating with a journal
+  attached, then recover from the snapshot and log and compare with the live graph.
+  * Round trip
+    - every recorded mutation (InsertNode, InsertEdge, InsertEdges, both erase overloads,
+      DeleteNode, Replace, MergeReplace, Clear) replays to an equal graph, for both
+      trivially copyable and string values
+    - the topological order and weight index settings come back from the snapshot
+    - assigning to a journaled graph is recorded as its new contents
+    - MergeReplace after DeleteNode replays the same whether or not a read has already cleaned
+      up the edges DeleteNode left behind
+  * What gets recorded
+    - failed and no-op mutations are not recorded
+    - MergeReplace is one record, not the inserts and deletes it is made of
+    - records are written a group at a time, and Flush writes a partial group
+  * Damage
+    - a torn last group is dropped and everything before it replays
+    - so is a group whose header claims far more bytes than the log holds
+    - a malformed snapshot, or a log that doesn't apply to it, throws and leaves the
+      graph untouched
+
+*/
+
+#include "assignments/dg/journal.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+SCENARIO("Recovering from a snapshot and journal") {
+  GIVEN("A snapshot of a graph with edges, and a journal attached after it") {
+    gdwg::Graph<std::string, double> g{"a", "b", "c"};
+    g.InsertEdge("a", "b", 1.5);
+    g.InsertEdge("b", "c", 2);
+    g.InsertEdge("c", "c", 3);
+    std::stringstream snapshot;
+    g.Snapshot(snapshot);
+    std::stringstream log;
+    gdwg::Journal journal{log, 4};
+    g.SetJournal(&journal);
+
+    WHEN("Every kind of mutation is made") {
+      g.InsertNode("d");
+      g.InsertEdge("d", "a", 4);
+      g.InsertEdges({{"a", "d", 5}, {"b", "d", 6}, {"a", "b", 1.5}});
+      g.erase("b", "c", 2);
+      g.erase(g.find("c", "c", 3));
+      g.Replace("b", "bee");
+      g.InsertNode("e");
+      g.InsertEdge("e", "a", 7);
+      g.MergeReplace("e", "d");
+      g.DeleteNode("c");
+      journal.Flush();
+      THEN("Recovering gives back the same graph") {
+        gdwg::Graph<std::string, double> recovered{"junk"};
+        REQUIRE(recovered.Recover(snapshot, log) == journal.Records());
+        REQUIRE(recovered == g);
+        REQUIRE(recovered.NumEdges() == g.NumEdges());
+      }
+    }
+
+    WHEN("The graph is cleared and rebuilt") {
+      g.Clear();
+      g.InsertNode("x");
+      journal.Flush();
+      THEN("Only the rebuilt graph comes back") {
+        gdwg::Graph<std::string, double> recovered;
+        recovered.Recover(snapshot, log);
+        REQUIRE(recovered.GetNodes() == std::vector<std::string>{"x"});
+      }
+    }
+
+    WHEN("Another graph is assigned to it") {
+      gdwg::Graph<std::string, double> other{"p", "q"};
+      other.InsertEdge("p", "q", 9);
+      g = other;
+      journal.Flush();
+      THEN("The assignment is recorded as the new contents") {
+        gdwg::Graph<std::string, double> recovered;
+        recovered.Recover(snapshot, log);
+        REQUIRE(recovered == other);
+      }
+    }
+
+    WHEN("Mutations fail or change nothing") {
+      g.InsertNode("a");
+      g.InsertEdge("a", "b", 1.5);
+      g.erase("a", "c", 1);
+      g.DeleteNode("z");
+      g.Replace("a", "b");
+      REQUIRE_THROWS(g.InsertEdge("a", "z", 1));
+      THEN("Nothing is recorded") { REQUIRE(journal.Records() == 0); }
+    }
+
+    WHEN("Nodes are merged") {
+      g.MergeReplace("a", "c");
+      THEN("Only the merge is recorded") { REQUIRE(journal.Records() == 1); }
+    }
+
+    WHEN("Fewer records than a group are made") {
+      g.InsertNode("d");
+      g.InsertNode("e");
+      g.InsertNode("f");
+      THEN("Nothing is written until the group fills or Flush is called") {
+        REQUIRE(log.str().empty());
+        g.InsertNode("g");
+        REQUIRE(journal.Groups() == 1);
+        REQUIRE(journal.Bytes() == log.str().size());
+        g.InsertNode("h");
+        journal.Flush();
+        REQUIRE(journal.Groups() == 2);
+      }
+    }
+
+    WHEN("The last group is torn") {
+      for (const auto& node : {"d", "e", "f", "g"}) {
+        g.InsertNode(node);
+      }
+      auto intact = log.str().size();
+      gdwg::Graph<std::string, double> expected{g};
+      g.InsertEdge("d", "e", 1);
+      journal.Flush();
+      auto torn = log.str().substr(0, log.str().size() - 3);
+      std::istringstream torn_log{torn};
+      THEN("Everything before it is recovered") {
+        REQUIRE(torn.size() > intact);
+        gdwg::Graph<std::string, double> recovered;
+        REQUIRE(recovered.Recover(snapshot, torn_log) == 4);
+        REQUIRE(recovered == expected);
+      }
+    }
+
+    WHEN("A group header claims more than the log holds") {
+      for (const auto& node : {"d", "e", "f", "g"}) {
+        g.InsertNode(node);
+      }
+      gdwg::Graph<std::string, double> expected{g};
+      std::string header;
+      gdwg::Codec<std::uint32_t>::Encode(header, 0xfffffff0u);
+      gdwg::Codec<std::uint32_t>::Encode(header, 0u);
+      std::istringstream corrupt_log{log.str() + header + "junk"};
+      THEN("It is treated as the end of the log") {
+        gdwg::Graph<std::string, double> recovered;
+        REQUIRE(recovered.Recover(snapshot, corrupt_log) == 4);
+        REQUIRE(recovered == expected);
+      }
+    }
+  }
+
+  GIVEN("A graph with a topological order and weight index") {
+    gdwg::Graph<int, int> g{1, 2, 3};
+    g.EnableTopologicalOrder();
+    g.EnableWeightIndex();
+    g.InsertEdge(1, 2, 5);
+    g.InsertEdge(2, 3, 4);
+    std::stringstream snapshot;
+    g.Snapshot(snapshot);
+    std::stringstream log;
+    {
+      gdwg::Journal journal{log};
+      g.SetJournal(&journal);
+      g.InsertEdge(1, 3, 1);
+      g.SetJournal(nullptr);
+    }
+    THEN("Recovery restores both along with the journaled edge") {
+      gdwg::Graph<int, int> recovered;
+      recovered.Recover(snapshot, log);
+      REQUIRE(recovered == g);
+      REQUIRE(recovered.MaintainsTopologicalOrder());
+      REQUIRE(recovered.TopologicalOrder() == std::vector<int>{1, 2, 3});
+      REQUIRE(recovered.HasWeightIndex());
+      REQUIRE(recovered.MinWeight(1, 3) == 1);
+    }
+  }
+
+  GIVEN("A journaled graph with edges into a deleted node") {
+    gdwg::Graph<int, int> g;
+    std::stringstream snapshot;
+    g.Snapshot(snapshot);
+    std::stringstream log;
+    gdwg::Journal journal{log};
+    g.SetJournal(&journal);
+    for (int node : {0, 1, 3, 7}) {
+      g.InsertNode(node);
+    }
+    g.InsertEdge(3, 3, 1);
+    g.InsertEdge(3, 0, 1);
+    g.DeleteNode(0);
+    WHEN("A read cleans up 3's edges before two other nodes are merged") {
+      g.OutDegree(3);
+      g.MergeReplace(1, 7);
+      journal.Flush();
+      THEN("The replay, which never made that read, gives the same graph") {
+        REQUIRE(g.IsConnected(3, 3));
+        gdwg::Graph<int, int> recovered;
+        recovered.Recover(snapshot, log);
+        REQUIRE(recovered.NumEdges() == 1);
+        REQUIRE(recovered == g);
+      }
+    }
+  }
+
+  GIVEN("A graph to recover into") {
+    gdwg::Graph<int, int> g{7};
+    std::stringstream good;
+    gdwg::Graph<int, int>{1, 2}.Snapshot(good);
+    THEN("A malformed snapshot throws and leaves it alone") {
+      std::istringstream empty_log;
+      std::istringstream garbage{"not a snapshot"};
+      REQUIRE_THROWS_WITH(g.Recover(garbage, empty_log),
+                          "Cannot call Graph::Recover with a malformed snapshot");
+      std::istringstream truncated{good.str().substr(0, good.str().size() - 1)};
+      REQUIRE_THROWS_WITH(g.Recover(truncated, empty_log),
+                          "Cannot call Graph::Recover with a malformed snapshot");
+      REQUIRE(g.GetNodes() == std::vector<int>{7});
+    }
+    THEN("A log that doesn't apply throws and leaves it alone") {
+      std::stringstream log;
+      {
+        gdwg::Journal journal{log};
+        journal.Record(gdwg::JournalOp::kInsertEdge, 1, 9, 0);
+      }
+      REQUIRE_THROWS_WITH(g.Recover(good, log),
+                          "Cannot call Graph::Recover with a log that doesn't apply to the "
+                          "snapshot");
+      REQUIRE(g.GetNodes() == std::vector<int>{7});
+    }
+  }
+}
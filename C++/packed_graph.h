@@ -0,0 +1,113 @@
+#ifndef ASSIGNMENTS_DG_PACKED_GRAPH_H_
+#define ASSIGNMENTS_DG_PACKED_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/filtered_view.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/intersect.h"
+
+namespace gdwg {
+
+// How a PackedGraph numbers its nodes. Every order but kValue puts nodes that share edges at
+// nearby ids, so a traversal's reads of the per-node arrays hit the same cache lines. Edge
+// direction is ignored when ordering.
+enum class NodeOrder {
+  // Increasing N, as the Graph iterates them
+  kValue,
+  // Decreasing in + out degree, so the hubs most traversals touch are packed together
+  kDegree,
+  // Breadth-first, one connected component after another
+  kBfs,
+  // Breadth-first from a low-degree node, visiting low-degree neighbours first, then reversed.
+  // Keeps each edge's endpoints close in id.
+  kReverseCuthillMcKee,
+};
+
+// Read-only compressed sparse row snapshot of a Graph.
+// Nodes are numbered 0..NumNodes()-1, by default in increasing order of N. Each node stores its
+// distinct out-neighbours as a sorted run of ids, and every (src, dst) slot owns a sorted run of
+// weights. The snapshot does not track later changes to the Graph it was built from.
+template <typename N, typename E>
+class PackedGraph {
+ public:
+  using NodeId = std::uint32_t;
+
+  PackedGraph() = default;
+  explicit PackedGraph(const gdwg::Graph<N, E>& g, NodeOrder order = NodeOrder::kValue);
+  // Packs only the nodes and edges in the view, numbered among themselves
+  template <typename NodePred, typename EdgePred>
+  explicit PackedGraph(const gdwg::FilteredView<N, E, NodePred, EdgePred>& view,
+                       NodeOrder order = NodeOrder::kValue);
+
+  std::size_t NumNodes() const noexcept { return nodes_.size(); }
+  // Number of (src, dst, weight) edges
+  std::size_t NumEdges() const noexcept { return weights_.size(); }
+
+  const N& Value(NodeId id) const { return nodes_[id]; }
+  const std::vector<N>& Nodes() const noexcept { return nodes_; }
+  std::optional<NodeId> IndexOf(const N& val) const;
+  NodeOrder Order() const noexcept { return order_; }
+  // Renumbering()[r] is the id of the node kValue would have numbered r, i.e. of the r-th
+  // smallest node. Empty under kValue, where the two are the same.
+  const std::vector<NodeId>& Renumbering() const noexcept { return renumbering_; }
+
+  // Distinct out-neighbours of id, sorted by id
+  const NodeId* NeighborsBegin(NodeId id) const { return targets_.data() + offsets_[id]; }
+  const NodeId* NeighborsEnd(NodeId id) const { return targets_.data() + offsets_[id + 1]; }
+  std::size_t OutDegree(NodeId id) const { return offsets_[id + 1] - offsets_[id]; }
+
+  // Out-neighbours shared by a and b, answered by sorted-run intersection
+  std::vector<N> CommonNeighbors(const N& a, const N& b) const;
+  std::size_t CountCommonNeighbors(const N& a, const N& b) const;
+  // |common| / |union| of the out-neighbour sets, or 0 if both are empty
+  double Jaccard(const N& a, const N& b) const;
+
+  // Slots index targets_; a slot's weights are weights_[weight_offsets_[s], weight_offsets_[s+1])
+  const std::vector<std::size_t>& Offsets() const noexcept { return offsets_; }
+  const std::vector<NodeId>& Targets() const noexcept { return targets_; }
+  const std::vector<std::size_t>& WeightOffsets() const noexcept { return weight_offsets_; }
+  const std::vector<E>& Weights() const noexcept { return weights_; }
+
+  // Incoming view: distinct in-neighbours of each node and the out-slot each one came from.
+  // Built on demand because only some traversals need it.
+  void BuildIncoming();
+  bool HasIncoming() const noexcept { return !in_offsets_.empty(); }
+  const NodeId* InNeighborsBegin(NodeId id) const { return in_sources_.data() + in_offsets_[id]; }
+  const NodeId* InNeighborsEnd(NodeId id) const { return in_sources_.data() + in_offsets_[id + 1]; }
+  std::size_t InDegree(NodeId id) const { return in_offsets_[id + 1] - in_offsets_[id]; }
+  const std::vector<std::size_t>& InOffsets() const noexcept { return in_offsets_; }
+  const std::vector<NodeId>& InSources() const noexcept { return in_sources_; }
+  const std::vector<std::size_t>& InSlots() const noexcept { return in_slots_; }
+
+ private:
+  template <typename KeepNode, typename KeepEdge>
+  void Pack(const gdwg::Graph<N, E>& g, const KeepNode& keep_node, const KeepEdge& keep_edge);
+  // New id of each node, indexed by its id in value order
+  std::vector<NodeId> Ordering(NodeOrder order);
+  void Renumber(std::vector<NodeId> ids);
+  std::pair<NodeId, NodeId> Endpoints(const N& a, const N& b, const char* what) const;
+
+  std::vector<N> nodes_;
+  std::vector<std::size_t> offsets_;
+  std::vector<NodeId> targets_;
+  std::vector<std::size_t> weight_offsets_;
+  std::vector<E> weights_;
+  NodeOrder order_ = NodeOrder::kValue;
+  std::vector<NodeId> renumbering_;
+
+  std::vector<std::size_t> in_offsets_;
+  std::vector<NodeId> in_sources_;
+  std::vector<std::size_t> in_slots_;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/packed_graph.tpp"
+
+#endif  // ASSIGNMENTS_DG_PACKED_GRAPH_H_
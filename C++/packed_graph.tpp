@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+//////////////////
+// CONSTRUCTORS //
+//////////////////
+
+template <typename N, typename E>
+gdwg::PackedGraph<N, E>::PackedGraph(const gdwg::Graph<N, E>& g, NodeOrder order) {
+  Pack(g, [](const N&) { return true; }, gdwg::KeepAllEdges{});
+  if (order != NodeOrder::kValue) {
+    Renumber(Ordering(order));
+    order_ = order;
+  }
+}
+
+template <typename N, typename E>
+template <typename NodePred, typename EdgePred>
+gdwg::PackedGraph<N, E>::PackedGraph(const gdwg::FilteredView<N, E, NodePred, EdgePred>& view,
+                                     NodeOrder order) {
+  Pack(view.Source(), view.NodePredicate(), view.EdgePredicate());
+  if (order != NodeOrder::kValue) {
+    Renumber(Ordering(order));
+    order_ = order;
+  }
+}
+
+template <typename N, typename E>
+template <typename KeepNode, typename KeepEdge>
+void gdwg::PackedGraph<N, E>::Pack(const gdwg::Graph<N, E>& g,
+                                   const KeepNode& keep_node,
+                                   const KeepEdge& keep_edge) {
+  // The map is already ordered by N, so ids follow map order and the dst lookup is by address
+  std::unordered_map<const N*, NodeId> ids;
+  ids.reserve(g.nodes_.size());
+  nodes_.reserve(g.nodes_.size());
+  std::vector<const typename gdwg::Graph<N, E>::Node*> kept;
+  kept.reserve(g.nodes_.size());
+  for (const auto& node : g.nodes_) {
+    if (keep_node(*node.first)) {
+      ids.emplace(node.first.get(), static_cast<NodeId>(nodes_.size()));
+      nodes_.push_back(*node.first);
+      kept.push_back(node.second.get());
+    }
+  }
+
+  offsets_.reserve(nodes_.size() + 1);
+  offsets_.push_back(0);
+  weight_offsets_.push_back(0);
+  std::vector<std::pair<NodeId, E>> scratch;
+  for (const auto* node : kept) {
+    scratch.clear();
+    for (const auto& edge : node->edges_) {
+      // Edges to deleted nodes are skipped rather than cleaned up; the Graph is untouched
+      auto dst = edge.first.lock();
+      auto id = dst ? ids.find(dst.get()) : ids.end();
+      if (id != ids.end() && keep_edge(*node->value_, *dst, edge.second)) {
+        scratch.emplace_back(id->second, edge.second);
+      }
+    }
+    std::sort(scratch.begin(), scratch.end(), [](const auto& a, const auto& b) {
+      return a.first < b.first || (a.first == b.first && a.second < b.second);
+    });
+    for (auto e = scratch.cbegin(); e != scratch.cend(); ++e) {
+      if (e == scratch.cbegin() || std::prev(e)->first != e->first) {
+        if (e != scratch.cbegin()) {
+          weight_offsets_.push_back(weights_.size());
+        }
+        targets_.push_back(e->first);
+      }
+      weights_.push_back(e->second);
+    }
+    if (!scratch.empty()) {
+      weight_offsets_.push_back(weights_.size());
+    }
+    offsets_.push_back(targets_.size());
+  }
+}
+
+template <typename N, typename E>
+std::vector<typename gdwg::PackedGraph<N, E>::NodeId>
+gdwg::PackedGraph<N, E>::Ordering(NodeOrder order) {
+  BuildIncoming();
+  auto n = nodes_.size();
+  auto by_degree = [this](NodeId a, NodeId b) {
+    return OutDegree(a) + InDegree(a) < OutDegree(b) + InDegree(b);
+  };
+  // Nodes in their new order
+  std::vector<NodeId> sequence(n);
+  std::iota(sequence.begin(), sequence.end(), NodeId{0});
+  if (order == NodeOrder::kDegree) {
+    std::stable_sort(sequence.begin(), sequence.end(),
+                     [&by_degree](NodeId a, NodeId b) { return by_degree(b, a); });
+  } else {
+    auto rcm = order == NodeOrder::kReverseCuthillMcKee;
+    // Cuthill-McKee starts each component from a low-degree node, a cheap stand-in for one on
+    // its periphery
+    auto roots = sequence;
+    if (rcm) {
+      std::stable_sort(roots.begin(), roots.end(), by_degree);
+    }
+    sequence.clear();
+    std::vector<bool> seen(n);
+    std::vector<NodeId> next;
+    for (auto root : roots) {
+      if (seen[root]) {
+        continue;
+      }
+      seen[root] = true;
+      sequence.push_back(root);
+      for (auto head = sequence.size() - 1; head < sequence.size(); ++head) {
+        auto u = sequence[head];
+        next.clear();
+        auto visit = [&](NodeId v) {
+          if (!seen[v]) {
+            seen[v] = true;
+            next.push_back(v);
+          }
+        };
+        std::for_each(NeighborsBegin(u), NeighborsEnd(u), visit);
+        std::for_each(InNeighborsBegin(u), InNeighborsEnd(u), visit);
+        if (rcm) {
+          std::stable_sort(next.begin(), next.end(), by_degree);
+        }
+        sequence.insert(sequence.end(), next.begin(), next.end());
+      }
+    }
+    if (rcm) {
+      std::reverse(sequence.begin(), sequence.end());
+    }
+  }
+
+  std::vector<NodeId> ids(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    ids[sequence[i]] = static_cast<NodeId>(i);
+  }
+  return ids;
+}
+
+// Moves every node to its new id and rebuilds the runs, re-sorting each one by the new ids
+template <typename N, typename E>
+void gdwg::PackedGraph<N, E>::Renumber(std::vector<NodeId> ids) {
+  auto n = nodes_.size();
+  std::vector<NodeId> old_ids(n);
+  for (std::size_t old = 0; old < n; ++old) {
+    old_ids[ids[old]] = static_cast<NodeId>(old);
+  }
+
+  std::vector<N> nodes;
+  nodes.reserve(n);
+  std::vector<std::size_t> offsets{0};
+  offsets.reserve(n + 1);
+  std::vector<NodeId> targets;
+  targets.reserve(targets_.size());
+  std::vector<std::size_t> weight_offsets{0};
+  weight_offsets.reserve(weight_offsets_.size());
+  std::vector<E> weights;
+  weights.reserve(weights_.size());
+  // (new dst, old slot)
+  std::vector<std::pair<NodeId, std::size_t>> run;
+  for (auto old : old_ids) {
+    nodes.push_back(std::move(nodes_[old]));
+    run.clear();
+    for (auto slot = offsets_[old]; slot < offsets_[old + 1]; ++slot) {
+      run.emplace_back(ids[targets_[slot]], slot);
+    }
+    std::sort(run.begin(), run.end());
+    for (const auto& [dst, slot] : run) {
+      targets.push_back(dst);
+      weights.insert(weights.end(),
+                     std::make_move_iterator(weights_.begin() + weight_offsets_[slot]),
+                     std::make_move_iterator(weights_.begin() + weight_offsets_[slot + 1]));
+      weight_offsets.push_back(weights.size());
+    }
+    offsets.push_back(targets.size());
+  }
+
+  nodes_ = std::move(nodes);
+  offsets_ = std::move(offsets);
+  targets_ = std::move(targets);
+  weight_offsets_ = std::move(weight_offsets);
+  weights_ = std::move(weights);
+  in_offsets_.clear();
+  in_sources_.clear();
+  in_slots_.clear();
+  renumbering_ = std::move(ids);
+}
+
+/////////////
+// METHODS //
+/////////////
+
+template <typename N, typename E>
+std::optional<typename gdwg::PackedGraph<N, E>::NodeId>
+gdwg::PackedGraph<N, E>::IndexOf(const N& val) const {
+  if (!renumbering_.empty()) {
+    // Renumbering lists the ids in increasing order of N, so it can be searched by value
+    auto it = std::lower_bound(renumbering_.cbegin(), renumbering_.cend(), val,
+                               [this](NodeId id, const N& v) { return nodes_[id] < v; });
+    if (it == renumbering_.cend() || val < nodes_[*it]) {
+      return std::nullopt;
+    }
+    return *it;
+  }
+  auto it = std::lower_bound(nodes_.cbegin(), nodes_.cend(), val);
+  if (it == nodes_.cend() || val < *it) {
+    return std::nullopt;
+  }
+  return static_cast<NodeId>(it - nodes_.cbegin());
+}
+
+template <typename N, typename E>
+void gdwg::PackedGraph<N, E>::BuildIncoming() {
+  if (HasIncoming()) {
+    return;
+  }
+  // Counting sort on dst keeps each in-neighbour run sorted by src
+  in_offsets_.assign(nodes_.size() + 1, 0);
+  for (auto dst : targets_) {
+    ++in_offsets_[dst + 1];
+  }
+  for (std::size_t i = 0; i < nodes_.size(); ++i) {
+    in_offsets_[i + 1] += in_offsets_[i];
+  }
+  in_sources_.resize(targets_.size());
+  in_slots_.resize(targets_.size());
+  auto cursor = in_offsets_;
+  for (NodeId src = 0; src < nodes_.size(); ++src) {
+    for (auto slot = offsets_[src]; slot < offsets_[src + 1]; ++slot) {
+      auto pos = cursor[targets_[slot]]++;
+      in_sources_[pos] = src;
+      in_slots_[pos] = slot;
+    }
+  }
+}
+
+template <typename N, typename E>
+std::pair<typename gdwg::PackedGraph<N, E>::NodeId, typename gdwg::PackedGraph<N, E>::NodeId>
+gdwg::PackedGraph<N, E>::Endpoints(const N& a, const N& b, const char* what) const {
+  auto a_id = IndexOf(a);
+  auto b_id = IndexOf(b);
+  if (!a_id || !b_id) {
+    throw std::out_of_range{std::string{"Cannot call PackedGraph::"} + what +
+                            " if a or b don't exist in the graph"};
+  }
+  return {*a_id, *b_id};
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::PackedGraph<N, E>::CommonNeighbors(const N& a, const N& b) const {
+  auto [a_id, b_id] = Endpoints(a, b, "CommonNeighbors");
+  std::vector<NodeId> ids(std::min(OutDegree(a_id), OutDegree(b_id)));
+  ids.resize(gdwg::detail::Intersect(NeighborsBegin(a_id), NeighborsEnd(a_id),
+                                     NeighborsBegin(b_id), NeighborsEnd(b_id), ids.data()));
+  std::vector<N> vec;
+  vec.reserve(ids.size());
+  for (auto id : ids) {
+    vec.push_back(nodes_[id]);
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+std::size_t gdwg::PackedGraph<N, E>::CountCommonNeighbors(const N& a, const N& b) const {
+  auto [a_id, b_id] = Endpoints(a, b, "CountCommonNeighbors");
+  return gdwg::detail::IntersectCount(NeighborsBegin(a_id), NeighborsEnd(a_id),
+                                      NeighborsBegin(b_id), NeighborsEnd(b_id));
+}
+
+template <typename N, typename E>
+double gdwg::PackedGraph<N, E>::Jaccard(const N& a, const N& b) const {
+  auto [a_id, b_id] = Endpoints(a, b, "Jaccard");
+  auto common = gdwg::detail::IntersectCount(NeighborsBegin(a_id), NeighborsEnd(a_id),
+                                             NeighborsBegin(b_id), NeighborsEnd(b_id));
+  auto total = OutDegree(a_id) + OutDegree(b_id) - common;
+  return total == 0 ? 0.0 : static_cast<double>(common) / static_cast<double>(total);
+}
@@ -0,0 +1,251 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  A PackedGraph is built from a Graph and its layout is checked first, since every query and
+  algorithm reads the raw arrays. The neighbour-set queries are then compared against the
+  obvious std::set_intersection over GetConnected.
+
+  * Construction
+    - empty graph
+    - ids follow node order, neighbours are distinct and weights are grouped and sorted
+    - edges to deleted nodes are skipped
+    - incoming view lists in-neighbours sorted by id
+  * Node orders
+    - every order packs the same edges and finds every node by value
+    - Renumbering maps value order to ids and is a permutation
+    - BFS and reverse Cuthill-McKee number a scrambled path so each edge joins adjacent ids
+    - degree order puts the hub first
+  * Intersection kernels
+    - runs of similar and very different lengths, covering the SIMD and galloping paths
+  * CommonNeighbors, CountCommonNeighbors and Jaccard
+    - a or b does not exist
+    - nodes with no shared neighbours and with no neighbours at all
+    - agreement with std::set_intersection on a larger graph
+
+*/
+
+#include "assignments/dg/packed_graph.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+SCENARIO("Packing a graph") {
+  GIVEN("An empty graph") {
+    gdwg::Graph<std::string, int> g;
+    gdwg::PackedGraph<std::string, int> packed{g};
+    THEN("The packed graph is empty") {
+      REQUIRE(packed.NumNodes() == 0);
+      REQUIRE(packed.NumEdges() == 0);
+      REQUIRE(packed.IndexOf("a") == std::nullopt);
+    }
+  }
+
+  GIVEN("A graph with parallel edges and an edge to a deleted node") {
+    gdwg::Graph<std::string, int> g{"c", "a", "b", "d"};
+    g.InsertEdge("a", "c", 3);
+    g.InsertEdge("a", "b", 2);
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("c", "a", 5);
+    g.InsertEdge("c", "d", 5);
+    g.DeleteNode("d");
+    gdwg::PackedGraph<std::string, int> packed{g};
+    THEN("Ids follow node order") {
+      REQUIRE(packed.Nodes() == std::vector<std::string>{"a", "b", "c"});
+      REQUIRE(packed.IndexOf("c") == 2);
+      REQUIRE(packed.IndexOf("d") == std::nullopt);
+    }
+    THEN("Neighbours are distinct and each slot's weights are sorted") {
+      REQUIRE(packed.NumEdges() == 4);
+      REQUIRE(packed.Offsets() == std::vector<std::size_t>{0, 2, 2, 3});
+      REQUIRE(packed.Targets() == std::vector<std::uint32_t>{1, 2, 0});
+      REQUIRE(packed.WeightOffsets() == std::vector<std::size_t>{0, 1, 3, 4});
+      REQUIRE(packed.Weights() == std::vector<int>{2, 1, 3, 5});
+    }
+    WHEN("The incoming view is built") {
+      packed.BuildIncoming();
+      THEN("In-neighbours point back at their out-slots") {
+        REQUIRE(packed.InOffsets() == std::vector<std::size_t>{0, 1, 2, 3});
+        REQUIRE(packed.InSources() == std::vector<std::uint32_t>{2, 0, 0});
+        REQUIRE(packed.InSlots() == std::vector<std::size_t>{2, 0, 1});
+      }
+    }
+  }
+}
+
+SCENARIO("Intersecting sorted id runs") {
+  GIVEN("Runs of assorted lengths and densities") {
+    unsigned seed = 5;
+    auto next = [&seed] {
+      seed = seed * 1103515245 + 12345;
+      return seed >> 8;
+    };
+    for (int trial = 0; trial < 200; ++trial) {
+      std::vector<std::uint32_t> a;
+      std::vector<std::uint32_t> b;
+      auto a_size = next() % 80;
+      auto b_size = trial % 2 ? next() % 80 : next() % 4000;
+      for (std::uint32_t v = 0; a.size() < a_size; v += 1 + next() % 4) {
+        a.push_back(v);
+      }
+      for (std::uint32_t v = 0; b.size() < b_size; v += 1 + next() % 3) {
+        b.push_back(v);
+      }
+      std::vector<std::uint32_t> expected;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+      std::vector<std::uint32_t> out(std::min(a.size(), b.size()));
+      auto count = gdwg::detail::Intersect(a.data(), a.data() + a.size(), b.data(),
+                                           b.data() + b.size(), out.data());
+      out.resize(count);
+      REQUIRE(out == expected);
+      REQUIRE(gdwg::detail::IntersectCount(b.data(), b.data() + b.size(), a.data(),
+                                           a.data() + a.size()) == expected.size());
+    }
+  }
+}
+
+SCENARIO("Common-neighbour queries") {
+  GIVEN("A small graph") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "f"};
+    g.InsertEdge("a", "c", 1);
+    g.InsertEdge("a", "d", 1);
+    g.InsertEdge("a", "e", 1);
+    g.InsertEdge("b", "d", 1);
+    g.InsertEdge("b", "d", 2);
+    g.InsertEdge("b", "e", 1);
+    g.InsertEdge("c", "f", 1);
+    gdwg::PackedGraph<std::string, int> packed{g};
+    THEN("Unknown nodes throw") {
+      REQUIRE_THROWS_WITH(packed.CommonNeighbors("a", "z"),
+                          "Cannot call PackedGraph::CommonNeighbors if a or b don't exist in the "
+                          "graph");
+      REQUIRE_THROWS_WITH(packed.Jaccard("z", "a"),
+                          "Cannot call PackedGraph::Jaccard if a or b don't exist in the graph");
+    }
+    THEN("Shared out-neighbours are reported once each") {
+      REQUIRE(packed.CommonNeighbors("a", "b") == std::vector<std::string>{"d", "e"});
+      REQUIRE(packed.CountCommonNeighbors("a", "b") == 2);
+      REQUIRE(packed.Jaccard("a", "b") == Approx(2.0 / 3));
+    }
+    THEN("Disjoint and empty neighbour sets give zero") {
+      REQUIRE(packed.CommonNeighbors("a", "c").empty());
+      REQUIRE(packed.Jaccard("a", "c") == 0.0);
+      REQUIRE(packed.Jaccard("e", "f") == 0.0);
+    }
+  }
+
+  GIVEN("A larger graph with a hub") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 2000; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i < 2000; i += 2) {
+      g.InsertEdge(0, i, 0);
+    }
+    for (int node = 1; node < 20; ++node) {
+      for (int i = node; i < 2000; i += node * 3) {
+        g.InsertEdge(node, i, 0);
+      }
+    }
+    gdwg::PackedGraph<int, int> packed{g};
+    THEN("Results match std::set_intersection over GetConnected") {
+      for (int a = 0; a < 20; ++a) {
+        for (int b = 0; b < 20; ++b) {
+          auto left = g.GetConnected(a);
+          auto right = g.GetConnected(b);
+          std::vector<int> expected;
+          std::set_intersection(left.begin(), left.end(), right.begin(), right.end(),
+                                std::back_inserter(expected));
+          REQUIRE(packed.CommonNeighbors(a, b) == expected);
+          REQUIRE(packed.CountCommonNeighbors(a, b) == expected.size());
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Renumbering nodes for locality") {
+  GIVEN("A path whose labels are scrambled, with parallel edges") {
+    // Step i joins label (11 i) mod 31 to the next one, so value order jumps along the path
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 31; ++i) {
+      g.InsertNode(i);
+    }
+    for (int i = 0; i + 1 < 31; ++i) {
+      g.InsertEdge(i * 11 % 31, (i + 1) * 11 % 31, i);
+      g.InsertEdge((i + 1) * 11 % 31, i * 11 % 31, -i);
+    }
+    g.InsertEdge(0, 11, 100);
+    std::vector<std::tuple<int, int, int>> edges(g.cbegin(), g.cend());
+
+    for (auto order : {gdwg::NodeOrder::kValue, gdwg::NodeOrder::kDegree, gdwg::NodeOrder::kBfs,
+                       gdwg::NodeOrder::kReverseCuthillMcKee}) {
+      gdwg::PackedGraph<int, int> packed{g, order};
+      std::vector<std::tuple<int, int, int>> packed_edges;
+      std::size_t bandwidth = 0;
+      bool sorted_runs = true;
+      for (gdwg::PackedGraph<int, int>::NodeId src = 0; src < packed.NumNodes(); ++src) {
+        sorted_runs = sorted_runs && std::is_sorted(packed.NeighborsBegin(src),
+                                                    packed.NeighborsEnd(src));
+        for (auto slot = packed.Offsets()[src]; slot < packed.Offsets()[src + 1]; ++slot) {
+          auto dst = packed.Targets()[slot];
+          bandwidth = std::max<std::size_t>(bandwidth, src > dst ? src - dst : dst - src);
+          for (auto w = packed.WeightOffsets()[slot]; w < packed.WeightOffsets()[slot + 1]; ++w) {
+            packed_edges.emplace_back(packed.Value(src), packed.Value(dst), packed.Weights()[w]);
+          }
+        }
+      }
+      std::sort(packed_edges.begin(), packed_edges.end());
+
+      THEN("It holds the same edges and finds every node") {
+        REQUIRE(packed.Order() == order);
+        REQUIRE(sorted_runs);
+        REQUIRE(packed_edges == edges);
+        for (int node = 0; node < 31; ++node) {
+          auto id = packed.IndexOf(node);
+          REQUIRE(id.has_value());
+          REQUIRE(packed.Value(*id) == node);
+          if (order != gdwg::NodeOrder::kValue) {
+            REQUIRE(packed.Renumbering()[static_cast<std::size_t>(node)] == *id);
+          }
+        }
+        REQUIRE(packed.IndexOf(-1) == std::nullopt);
+        REQUIRE(packed.IndexOf(31) == std::nullopt);
+        REQUIRE(packed.CommonNeighbors(0, 22) == std::vector<int>{11});
+      }
+      if (order == gdwg::NodeOrder::kValue) {
+        THEN("Value order leaves the path scattered") {
+          REQUIRE(packed.Renumbering().empty());
+          REQUIRE(bandwidth > 1);
+        }
+      } else if (order != gdwg::NodeOrder::kDegree) {
+        THEN("Each edge joins adjacent ids") {
+          REQUIRE(bandwidth == 1);
+        }
+      }
+    }
+  }
+
+  GIVEN("A star with a few extra edges") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "hub"};
+    for (const auto* leaf : {"a", "b", "c", "d"}) {
+      g.InsertEdge("hub", leaf, 1);
+    }
+    g.InsertEdge("a", "b", 2);
+    gdwg::PackedGraph<std::string, int> packed{g, gdwg::NodeOrder::kDegree};
+    THEN("Degree order puts the hub first, ties keeping value order") {
+      REQUIRE(packed.Nodes() == std::vector<std::string>{"hub", "a", "b", "c", "d"});
+      REQUIRE(packed.Renumbering() == std::vector<gdwg::PackedGraph<std::string, int>::NodeId>{
+                                          1, 2, 3, 4, 0});
+      packed.BuildIncoming();
+      REQUIRE(packed.InDegree(*packed.IndexOf("b")) == 2);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+#ifndef ASSIGNMENTS_DG_PARTITION_H_
+#define ASSIGNMENTS_DG_PARTITION_H_
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "assignments/dg/executor.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/packed_graph.h"
+
+namespace gdwg {
+
+struct PartitionOptions {
+  // How far above n / k a part may grow, as a fraction; parts may also shrink as far below it
+  double imbalance = 0.03;
+  std::size_t max_rounds = 32;
+};
+
+template <typename N>
+struct PartitionResult {
+  // Every node, in increasing order even if the PackedGraph partitioned was renumbered
+  std::vector<N> nodes;
+  // Part of each node, in [0, num_parts)
+  std::vector<std::size_t> part;
+  std::size_t num_parts;
+  std::vector<std::size_t> part_sizes;
+  // Edges are counted once per weight, as Graph::NumEdges does. Self loops are never cut.
+  std::size_t num_edges;
+  std::size_t cut_edges;
+  // Edges leaving each part for another one
+  std::vector<std::size_t> boundary_edges;
+  // Refinement rounds run before no node could move
+  std::size_t rounds;
+};
+
+// Splits the nodes into k parts of balanced size while cutting few edges. Edge direction is
+// ignored. Nodes are first dealt out in breadth-first order, so each part starts as a few
+// connected regions. Rounds of label propagation then refine it: every node picks, in
+// parallel, the neighbouring part it has the most edges to, and the moves that still cut
+// fewer edges are applied best first while the part sizes stay in bounds.
+// The result is the same whatever the number of threads.
+template <typename N, typename E>
+PartitionResult<N> Partition(const gdwg::Graph<N, E>& g,
+                             std::size_t k,
+                             PartitionOptions options = {},
+                             std::size_t threads = std::thread::hardware_concurrency());
+template <typename N, typename E>
+PartitionResult<N> Partition(gdwg::PackedGraph<N, E>& g,
+                             std::size_t k,
+                             gdwg::Executor& pool,
+                             PartitionOptions options = {});
+
+template <typename N, typename E>
+struct BoundaryEdge {
+  N src;
+  N dst;
+  E weight;
+  std::size_t dst_part;
+};
+
+template <typename N, typename E>
+struct Shards {
+  // The subgraph induced by each part
+  std::vector<gdwg::Graph<N, E>> graphs;
+  // The edges leaving each shard, which no shard holds, sorted by src, dst and weight
+  std::vector<std::vector<BoundaryEdge<N, E>>> boundary;
+};
+
+// Copies each part of a partition of g into a Graph of its own
+template <typename N, typename E>
+Shards<N, E> MakeShards(const gdwg::Graph<N, E>& g, const PartitionResult<N>& partition);
+
+}  // namespace gdwg
+
+#include "assignments/dg/partition.tpp"
+
+#endif  // ASSIGNMENTS_DG_PARTITION_H_
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+namespace detail {
+
+// Undirected view of a PackedGraph: every distinct (src, dst) pair appears in both endpoints'
+// runs, weighted by the number of edges it stands for. Self loops are left out.
+struct UndirectedAdjacency {
+  std::vector<std::size_t> offsets;
+  std::vector<std::size_t> targets;
+  std::vector<std::size_t> weights;
+};
+
+template <typename N, typename E>
+UndirectedAdjacency Undirected(gdwg::PackedGraph<N, E>& g) {
+  g.BuildIncoming();
+  auto n = g.NumNodes();
+  const auto& targets = g.Targets();
+  const auto& weight_offsets = g.WeightOffsets();
+  auto edges = [&weight_offsets](std::size_t slot) {
+    return weight_offsets[slot + 1] - weight_offsets[slot];
+  };
+
+  UndirectedAdjacency adj;
+  adj.offsets.assign(n + 1, 0);
+  for (std::size_t u = 0; u < n; ++u) {
+    adj.offsets[u + 1] = adj.offsets[u] + g.OutDegree(u) + g.InDegree(u);
+  }
+  adj.targets.reserve(adj.offsets[n]);
+  adj.weights.reserve(adj.offsets[n]);
+  for (std::size_t u = 0; u < n; ++u) {
+    for (auto slot = g.Offsets()[u]; slot < g.Offsets()[u + 1]; ++slot) {
+      if (targets[slot] != u) {
+        adj.targets.push_back(targets[slot]);
+        adj.weights.push_back(edges(slot));
+      }
+    }
+    for (auto i = g.InOffsets()[u]; i < g.InOffsets()[u + 1]; ++i) {
+      if (g.InSources()[i] != u) {
+        adj.targets.push_back(g.InSources()[i]);
+        adj.weights.push_back(edges(g.InSlots()[i]));
+      }
+    }
+    adj.offsets[u + 1] = adj.targets.size();
+  }
+  return adj;
+}
+
+// Counts a node's edges into each part. The counts live in a k-sized array that is only
+// touched where needed, so a high-degree node costs its degree rather than k.
+class PartConnections {
+ public:
+  explicit PartConnections(std::size_t k) : count_(k) {}
+
+  void Count(const UndirectedAdjacency& adj, const std::vector<std::size_t>& part, std::size_t u) {
+    for (auto p : touched_) {
+      count_[p] = 0;
+    }
+    touched_.clear();
+    for (auto i = adj.offsets[u]; i < adj.offsets[u + 1]; ++i) {
+      auto p = part[adj.targets[i]];
+      if (count_[p] == 0) {
+        touched_.push_back(p);
+      }
+      count_[p] += adj.weights[i];
+    }
+  }
+
+  std::size_t To(std::size_t p) const { return count_[p]; }
+  // Parts the last counted node has edges into
+  const std::vector<std::size_t>& Touched() const noexcept { return touched_; }
+
+ private:
+  std::vector<std::size_t> count_;
+  std::vector<std::size_t> touched_;
+};
+
+}  // namespace detail
+}  // namespace gdwg
+
+///////////////
+// PARTITION //
+///////////////
+
+template <typename N, typename E>
+gdwg::PartitionResult<N> gdwg::Partition(const gdwg::Graph<N, E>& g,
+                                         std::size_t k,
+                                         PartitionOptions options,
+                                         std::size_t threads) {
+  gdwg::PackedGraph<N, E> packed{g};
+  gdwg::Executor pool{threads};
+  return gdwg::Partition(packed, k, pool, options);
+}
+
+template <typename N, typename E>
+gdwg::PartitionResult<N> gdwg::Partition(gdwg::PackedGraph<N, E>& g,
+                                         std::size_t k,
+                                         gdwg::Executor& pool,
+                                         PartitionOptions options) {
+  if (k == 0) {
+    throw std::invalid_argument{"Cannot call Partition with zero parts"};
+  }
+  if (!(options.imbalance >= 0)) {
+    throw std::invalid_argument{"Cannot call Partition with a negative imbalance"};
+  }
+  auto n = g.NumNodes();
+  gdwg::PartitionResult<N> result{g.Nodes(),
+                                  std::vector<std::size_t>(n),
+                                  k,
+                                  std::vector<std::size_t>(k),
+                                  g.NumEdges(),
+                                  0,
+                                  std::vector<std::size_t>(k),
+                                  0};
+  auto& part = result.part;
+  auto& sizes = result.part_sizes;
+  auto adj = gdwg::detail::Undirected(g);
+
+  // Deal the nodes out in breadth-first order: part p takes the next n / k of them, plus one
+  // of the n % k left over
+  std::vector<std::size_t> order;
+  order.reserve(n);
+  std::vector<bool> seen(n);
+  for (std::size_t root = 0; root < n; ++root) {
+    if (seen[root]) {
+      continue;
+    }
+    seen[root] = true;
+    order.push_back(root);
+    for (auto head = order.size() - 1; head < order.size(); ++head) {
+      auto u = order[head];
+      for (auto i = adj.offsets[u]; i < adj.offsets[u + 1]; ++i) {
+        if (!seen[adj.targets[i]]) {
+          seen[adj.targets[i]] = true;
+          order.push_back(adj.targets[i]);
+        }
+      }
+    }
+  }
+  for (std::size_t i = 0, p = 0; i < n; ++i) {
+    while (sizes[p] == n / k + (p < n % k ? 1 : 0)) {
+      ++p;
+    }
+    part[order[i]] = p;
+    ++sizes[p];
+  }
+
+  auto ideal = static_cast<double>(n) / static_cast<double>(k);
+  auto upper = std::max(static_cast<std::size_t>(std::ceil(ideal * (1 + options.imbalance))),
+                        (n + k - 1) / k);
+  auto lower = std::min(static_cast<std::size_t>(std::floor(ideal * (1 - options.imbalance))),
+                        n / k);
+
+  struct Move {
+    std::size_t node;
+    std::size_t to;
+    std::size_t gain;
+  };
+  std::vector<std::vector<Move>> local(pool.Size());
+  std::vector<gdwg::detail::PartConnections> scratch(pool.Size(),
+                                                     gdwg::detail::PartConnections{k});
+  std::vector<Move> moves;
+  while (result.rounds < options.max_rounds) {
+    ++result.rounds;
+    // Every node proposes the part it has the most edges to, lowest id on ties, against
+    // this round's assignment
+    pool.ParallelFor(0, n, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+      auto& conn = scratch[worker];
+      for (auto u = lo; u < hi; ++u) {
+        conn.Count(adj, part, u);
+        Move best{u, part[u], conn.To(part[u])};
+        for (auto p : conn.Touched()) {
+          if (conn.To(p) > best.gain || (conn.To(p) == best.gain && p < best.to)) {
+            best = {u, p, conn.To(p)};
+          }
+        }
+        if (best.to != part[u]) {
+          best.gain -= conn.To(part[u]);
+          local[worker].push_back(best);
+        }
+      }
+    });
+
+    moves.clear();
+    for (auto& proposals : local) {
+      moves.insert(moves.end(), proposals.begin(), proposals.end());
+      proposals.clear();
+    }
+    std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+      return std::tie(b.gain, a.node) < std::tie(a.gain, b.node);
+    });
+
+    // Earlier moves may have changed a node's neighbourhood, so each gain is counted again
+    // before the move is made
+    std::size_t moved = 0;
+    auto& conn = scratch[0];
+    for (const auto& move : moves) {
+      auto from = part[move.node];
+      if (sizes[move.to] >= upper || sizes[from] <= lower) {
+        continue;
+      }
+      conn.Count(adj, part, move.node);
+      if (conn.To(move.to) > conn.To(from)) {
+        part[move.node] = move.to;
+        --sizes[from];
+        ++sizes[move.to];
+        ++moved;
+      }
+    }
+    if (moved == 0) {
+      break;
+    }
+  }
+
+  for (std::size_t u = 0; u < n; ++u) {
+    for (auto slot = g.Offsets()[u]; slot < g.Offsets()[u + 1]; ++slot) {
+      if (part[g.Targets()[slot]] != part[u]) {
+        auto edges = g.WeightOffsets()[slot + 1] - g.WeightOffsets()[slot];
+        result.cut_edges += edges;
+        result.boundary_edges[part[u]] += edges;
+      }
+    }
+  }
+  // Report the nodes in increasing order whatever g's numbering, as MakeShards expects
+  const auto& renumbering = g.Renumbering();
+  if (!renumbering.empty()) {
+    std::vector<std::size_t> by_value(n);
+    for (std::size_t r = 0; r < n; ++r) {
+      result.nodes[r] = g.Value(renumbering[r]);
+      by_value[r] = part[renumbering[r]];
+    }
+    part = std::move(by_value);
+  }
+  return result;
+}
+
+////////////
+// SHARDS //
+////////////
+
+template <typename N, typename E>
+gdwg::Shards<N, E> gdwg::MakeShards(const gdwg::Graph<N, E>& g,
+                                    const PartitionResult<N>& partition) {
+  const auto& nodes = partition.nodes;
+  if (nodes.size() != g.size() || partition.part.size() != nodes.size()) {
+    throw std::invalid_argument{"Cannot call MakeShards with a partition of a different graph"};
+  }
+  auto part_of = [&](const N& val) {
+    auto it = std::lower_bound(nodes.begin(), nodes.end(), val);
+    if (it == nodes.end() || *it != val) {
+      throw std::invalid_argument{"Cannot call MakeShards with a partition of a different graph"};
+    }
+    return partition.part[static_cast<std::size_t>(it - nodes.begin())];
+  };
+
+  std::vector<std::vector<N>> members(partition.num_parts);
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    members[partition.part[i]].push_back(nodes[i]);
+  }
+  gdwg::Shards<N, E> shards;
+  shards.graphs.reserve(partition.num_parts);
+  shards.boundary.resize(partition.num_parts);
+  for (const auto& member : members) {
+    shards.graphs.push_back(g.InducedSubgraph(member));
+  }
+  // Edges come out sorted by src, dst and weight, so each table is too
+  for (auto it = g.cbegin(); it != g.cend(); ++it) {
+    const auto& [src, dst, w] = *it;
+    auto from = part_of(src);
+    auto to = part_of(dst);
+    if (from != to) {
+      shards.boundary[from].push_back({src, dst, w, to});
+    }
+  }
+  return shards;
+}
@@ -0,0 +1,267 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  Partitioning is a heuristic, so the tests fix what must always hold and check quality only
+  where the best answer is obvious or a loose bound is enough to tell it from hash sharding.
+  * Partition
+    - zero parts and a negative imbalance throw
+    - two dense clusters joined by one edge are split along that edge
+    - a grid stays within the size bounds and cuts a small fraction of its edges
+    - the cut statistics agree with counting crossing edges by brute force, with repeated
+      weights and self loops in the graph
+    - the same partition comes back whatever the number of threads
+    - more parts than nodes, and the empty graph
+  * MakeShards
+    - every node lands in its part's shard, with the edges inside the part
+    - the boundary tables hold exactly the cut edges, sorted, with the part each dst is in
+    - a partition of a different graph throws
+    - partitioning a renumbered PackedGraph gives a partition its Graph can be sharded by
+
+*/
+
+#include "assignments/dg/partition.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "assignments/dg/executor.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/packed_graph.h"
+#include "catch.h"
+
+namespace {
+
+// Two clusters of size nodes where every node has an edge to every other, joined by a0 -> b0
+void Barbell(gdwg::Graph<std::string, int>& g, int size) {
+  for (auto side : {"a", "b"}) {
+    for (int i = 0; i < size; ++i) {
+      g.InsertNode(side + std::to_string(i));
+    }
+    for (int i = 0; i < size; ++i) {
+      for (int j = 0; j < size; ++j) {
+        if (i != j) {
+          g.InsertEdge(side + std::to_string(i), side + std::to_string(j), 1);
+        }
+      }
+    }
+  }
+  g.InsertEdge("a0", "b0", 2);
+}
+
+void Grid(gdwg::Graph<int, int>& g, int side) {
+  for (int i = 0; i < side * side; ++i) {
+    g.InsertNode(i);
+  }
+  for (int r = 0; r < side; ++r) {
+    for (int c = 0; c < side; ++c) {
+      if (c + 1 < side) {
+        g.InsertEdge(r * side + c, r * side + c + 1, r);
+      }
+      if (r + 1 < side) {
+        g.InsertEdge(r * side + c, (r + 1) * side + c, c);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+SCENARIO("Partitioning a graph") {
+  GIVEN("Bad arguments") {
+    gdwg::Graph<int, int> g{1, 2};
+    THEN("They throw") {
+      REQUIRE_THROWS_WITH(gdwg::Partition(g, 0), "Cannot call Partition with zero parts");
+      gdwg::PartitionOptions options;
+      options.imbalance = -0.5;
+      REQUIRE_THROWS_WITH(gdwg::Partition(g, 2, options),
+                          "Cannot call Partition with a negative imbalance");
+    }
+  }
+
+  GIVEN("Two dense clusters joined by one edge") {
+    gdwg::Graph<std::string, int> g;
+    Barbell(g, 6);
+    WHEN("It is split in two") {
+      auto result = gdwg::Partition(g, 2);
+      THEN("Only the joining edge is cut") {
+        REQUIRE(result.part_sizes == std::vector<std::size_t>{6, 6});
+        REQUIRE(result.cut_edges == 1);
+        REQUIRE(result.num_edges == g.NumEdges());
+        for (std::size_t i = 0; i < result.nodes.size(); ++i) {
+          auto same = std::find(result.nodes.begin(), result.nodes.end(),
+                                std::string{result.nodes[i][0]} + "0");
+          REQUIRE(result.part[i] == result.part[static_cast<std::size_t>(
+                                        same - result.nodes.begin())]);
+        }
+      }
+    }
+  }
+
+  GIVEN("A 24 by 24 grid") {
+    gdwg::Graph<int, int> g;
+    Grid(g, 24);
+    WHEN("It is split in four") {
+      gdwg::PartitionOptions options;
+      options.imbalance = 0.05;
+      auto result = gdwg::Partition(g, 4, options, 4);
+      THEN("Parts stay in bounds and few edges are cut") {
+        for (auto size : result.part_sizes) {
+          REQUIRE(size >= 136);
+          REQUIRE(size <= 152);
+        }
+        // Hash sharding would cut about three quarters of them
+        REQUIRE(result.cut_edges * 8 < result.num_edges);
+      }
+      THEN("Any number of threads gives the same answer") {
+        auto single = gdwg::Partition(g, 4, options, 1);
+        REQUIRE(single.part == result.part);
+        REQUIRE(single.rounds == result.rounds);
+      }
+    }
+  }
+
+  GIVEN("A pseudo-random graph with repeated pairs and self loops") {
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < 300; ++i) {
+      g.InsertNode(i);
+    }
+    unsigned state = 7;
+    for (int i = 0; i < 1500; ++i) {
+      state = state * 1103515245u + 12345u;
+      auto src = static_cast<int>((state >> 8) % 300);
+      state = state * 1103515245u + 12345u;
+      auto dst = i % 10 == 0 ? src : static_cast<int>((state >> 8) % 300);
+      g.InsertEdge(src, dst, i % 3);
+    }
+    auto result = gdwg::Partition(g, 5);
+    THEN("The cut statistics match a brute-force count") {
+      std::vector<std::size_t> boundary(5);
+      std::size_t cut = 0;
+      auto part_of = [&](int node) { return result.part[static_cast<std::size_t>(node)]; };
+      for (auto it = g.cbegin(); it != g.cend(); ++it) {
+        const auto& [src, dst, w] = *it;
+        if (part_of(src) != part_of(dst)) {
+          ++cut;
+          ++boundary[part_of(src)];
+        }
+      }
+      REQUIRE(result.cut_edges == cut);
+      REQUIRE(result.boundary_edges == boundary);
+      REQUIRE(result.rounds > 0);
+      for (auto size : result.part_sizes) {
+        REQUIRE(size >= 58);
+        REQUIRE(size <= 62);
+      }
+    }
+  }
+
+  GIVEN("More parts than nodes") {
+    gdwg::Graph<int, int> g{1, 2, 3};
+    g.InsertEdge(1, 2, 0);
+    auto result = gdwg::Partition(g, 5);
+    THEN("Each node gets a part to itself") {
+      REQUIRE(result.part_sizes == std::vector<std::size_t>{1, 1, 1, 0, 0});
+      REQUIRE(result.cut_edges == 1);
+    }
+  }
+
+  GIVEN("An empty graph") {
+    gdwg::Graph<int, int> g;
+    auto result = gdwg::Partition(g, 3);
+    THEN("Every part is empty") {
+      REQUIRE(result.part_sizes == std::vector<std::size_t>{0, 0, 0});
+      REQUIRE(result.cut_edges == 0);
+    }
+  }
+}
+
+SCENARIO("Sharding a partitioned graph") {
+  GIVEN("A partition of two joined clusters with a stray node") {
+    gdwg::Graph<std::string, int> g;
+    Barbell(g, 4);
+    g.InsertNode("c");
+    g.InsertEdge("b1", "a2", 5);
+    g.InsertEdge("b1", "a2", 3);
+    auto partition = gdwg::Partition(g, 2);
+    auto shards = gdwg::MakeShards(g, partition);
+
+    THEN("Each shard holds its part and the edges inside it") {
+      REQUIRE(shards.graphs.size() == 2);
+      std::size_t nodes = 0;
+      std::size_t edges = 0;
+      for (std::size_t p = 0; p < 2; ++p) {
+        auto& shard = shards.graphs[p];
+        for (const auto& node : shard.GetNodes()) {
+          auto it = std::lower_bound(partition.nodes.begin(), partition.nodes.end(), node);
+          REQUIRE(partition.part[static_cast<std::size_t>(it - partition.nodes.begin())] == p);
+        }
+        nodes += shard.size();
+        edges += shard.NumEdges();
+      }
+      REQUIRE(nodes == g.size());
+      REQUIRE(edges + partition.cut_edges == g.NumEdges());
+    }
+
+    THEN("The boundary tables hold the cut edges") {
+      std::size_t cut = 0;
+      for (std::size_t p = 0; p < 2; ++p) {
+        const auto& table = shards.boundary[p];
+        REQUIRE(table.size() == partition.boundary_edges[p]);
+        REQUIRE(std::is_sorted(table.begin(), table.end(), [](const auto& a, const auto& b) {
+          return std::tie(a.src, a.dst, a.weight) < std::tie(b.src, b.dst, b.weight);
+        }));
+        for (const auto& edge : table) {
+          REQUIRE(shards.graphs[p].IsNode(edge.src));
+          REQUIRE(edge.dst_part != p);
+          REQUIRE(shards.graphs[edge.dst_part].IsNode(edge.dst));
+          REQUIRE(g.IsConnected(edge.src, edge.dst));
+        }
+        cut += table.size();
+      }
+      REQUIRE(cut == partition.cut_edges);
+    }
+
+    WHEN("The graph changes before sharding") {
+      g.InsertNode("d");
+      THEN("The partition no longer fits it") {
+        REQUIRE_THROWS_WITH(gdwg::MakeShards(g, partition),
+                            "Cannot call MakeShards with a partition of a different graph");
+      }
+    }
+  }
+
+  GIVEN("A partition of a PackedGraph renumbered by reverse Cuthill-McKee") {
+    gdwg::Graph<std::string, int> g;
+    Barbell(g, 4);
+    g.InsertNode("c");
+    gdwg::PackedGraph<std::string, int> packed{g, gdwg::NodeOrder::kReverseCuthillMcKee};
+    gdwg::Executor pool{2};
+    auto partition = gdwg::Partition(packed, 2, pool);
+    THEN("Its nodes are in increasing order with their parts, and it shards g") {
+      REQUIRE(packed.Nodes() != g.GetNodes());
+      REQUIRE(partition.nodes == g.GetNodes());
+      auto part_of = [&partition](const std::string& node) {
+        auto it = std::lower_bound(partition.nodes.begin(), partition.nodes.end(), node);
+        return partition.part[static_cast<std::size_t>(it - partition.nodes.begin())];
+      };
+      std::size_t cut = 0;
+      for (const auto& [src, dst, w] : g) {
+        cut += part_of(src) != part_of(dst);
+      }
+      REQUIRE(cut == partition.cut_edges);
+      auto shards = gdwg::MakeShards(g, partition);
+      std::size_t edges = 0;
+      for (std::size_t p = 0; p < 2; ++p) {
+        for (const auto& node : shards.graphs[p].GetNodes()) {
+          REQUIRE(part_of(node) == p);
+        }
+        edges += shards.graphs[p].NumEdges();
+      }
+      REQUIRE(edges + partition.cut_edges == g.NumEdges());
+    }
+  }
+}
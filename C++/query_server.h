@@ -0,0 +1,544 @@
+#ifndef ASSIGNMENTS_DG_QUERY_SERVER_H_
+#define ASSIGNMENTS_DG_QUERY_SERVER_H_
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/journal.h"
+#include "assignments/dg/shared_graph.h"
+
+namespace gdwg {
+
+// Wire format shared by QueryServer and QueryClient. Both ends must run on the same host, so
+// values are encoded with Codec, byte for byte. Every message is a frame: a u32 byte length,
+// then the body.
+//  * request body: queries, each an op byte then src, and dst for kIsConnected
+//  * response body: one answer per query, in order: a status byte, then for kOk either a
+//    connected byte or a u64 count and that many nodes. A response that would outgrow the
+//    server's frame limit ends early with kTooLarge, and the rest of the batch is asked again.
+enum class QueryOp : std::uint8_t { kIsConnected = 1, kGetConnected };
+enum class QueryStatus : std::uint8_t { kOk = 0, kMissingNode, kBadRequest, kTooLarge };
+
+namespace detail {
+
+// Largest request frame a server reads, so a broken client can't make it allocate without bound
+constexpr std::uint32_t kMaxRequestFrame = std::uint32_t{64} << 20;
+// Default for the largest response frame a server writes, well inside the u32 length
+constexpr std::uint32_t kMaxResponseFrame = std::uint32_t{1} << 30;
+// Most bytes a server reads from one connection per wake-up
+constexpr std::size_t kReceiveChunk = std::size_t{64} << 10;
+
+inline sockaddr_un SocketAddress(const std::string& path, const char* caller) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    throw std::invalid_argument{std::string{"Cannot call "} + caller +
+                                " with a socket path that is empty or too long"};
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return addr;
+}
+
+inline bool SendAll(int fd, const char* data, std::size_t size) {
+  while (size > 0) {
+    auto sent = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= static_cast<std::size_t>(sent);
+  }
+  return true;
+}
+
+inline bool ReceiveAll(int fd, char* data, std::size_t size) {
+  while (size > 0) {
+    auto got = ::recv(fd, data, size, 0);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      return false;
+    }
+    data += got;
+    size -= static_cast<std::size_t>(got);
+  }
+  return true;
+}
+
+// Refuses a body too long for the u32 length rather than truncating it
+inline bool SendFrame(int fd, const std::string& body) {
+  if (body.size() > UINT32_MAX) {
+    return false;
+  }
+  std::string header;
+  Codec<std::uint32_t>::Encode(header, static_cast<std::uint32_t>(body.size()));
+  return SendAll(fd, header.data(), header.size()) && SendAll(fd, body.data(), body.size());
+}
+
+inline bool ReceiveFrame(int fd, std::string& body, std::uint32_t limit) {
+  char header[sizeof(std::uint32_t)];
+  if (!ReceiveAll(fd, header, sizeof(header))) {
+    return false;
+  }
+  const char* in = header;
+  std::uint32_t size;
+  Codec<std::uint32_t>::Decode(in, header + sizeof(header), size);
+  if (size > limit) {
+    return false;
+  }
+  body.resize(size);
+  return size == 0 || ReceiveAll(fd, &body[0], size);
+}
+
+}  // namespace detail
+
+// Answers IsConnected and GetConnected over a Unix-domain stream socket, for processes that
+// can't map a SharedGraph themselves. Clients send many queries per frame, so one round trip
+// and one wake-up of the server covers a whole batch.
+// Run serves every connection from the calling thread until Stop. Sockets are non-blocking and
+// each connection keeps its partial request and unsent answers, so a client that stalls
+// mid-frame or stops reading only holds up itself.
+template <typename N, typename E>
+class QueryServer {
+ public:
+  // Listens on path, replacing any stale socket file there; anything else at path throws.
+  // g must outlive the server.
+  // Response frames are split to stay within max_response bytes.
+  QueryServer(const gdwg::SharedGraph<N, E>& g,
+              std::string path,
+              std::uint32_t max_response = gdwg::detail::kMaxResponseFrame);
+  QueryServer(const QueryServer&) = delete;
+  QueryServer& operator=(const QueryServer&) = delete;
+  // Closes every connection and removes the socket file. Stop and join Run's thread first.
+  ~QueryServer();
+
+  void Run();
+  // Makes Run return; safe to call from any thread
+  void Stop() noexcept;
+
+  std::size_t Batches() const noexcept { return batches_.load(std::memory_order_relaxed); }
+  std::size_t Queries() const noexcept { return queries_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Connection {
+    int fd;
+    // Bytes received but not yet answered, at most one partial request frame
+    std::string in;
+    // Response frames not yet sent, from out[sent] on
+    std::string out;
+    std::size_t sent = 0;
+  };
+
+  // Reads what has arrived, or sends what is waiting, then answers complete request frames;
+  // returns false if the connection should be closed
+  bool Serve(Connection& c, short revents);
+  // Answers buffered frames until there is nothing complete left or the answers can't all be
+  // sent yet, so a client that stops reading only has one chunk of answers queued for it
+  bool Parse(Connection& c);
+  bool Send(Connection& c);
+  // Appends the answers to a request body to response
+  void Answer(const char* in, const char* end, std::string& response);
+
+  const gdwg::SharedGraph<N, E>& g_;
+  std::string path_;
+  std::uint32_t max_response_;
+  int listener_ = -1;
+  // Stop writes to wake_[1] to wake Run's poll
+  int wake_[2] = {-1, -1};
+  std::vector<Connection> clients_;
+  std::atomic<std::size_t> batches_{0};
+  std::atomic<std::size_t> queries_{0};
+};
+
+// Connection to a QueryServer. Each call sends its queries as one batch and waits for the
+// answers; calls on one client must not overlap.
+template <typename N>
+class QueryClient {
+  static_assert(std::is_trivially_copyable_v<N>, "QueryClient receives nodes byte for byte");
+
+ public:
+  explicit QueryClient(const std::string& path);
+  QueryClient(const QueryClient&) = delete;
+  QueryClient& operator=(const QueryClient&) = delete;
+  ~QueryClient() { ::close(fd_); }
+
+  // Throw like the Graph calls if any query names a node that doesn't exist
+  std::vector<bool> IsConnected(const std::vector<std::pair<N, N>>& pairs);
+  std::vector<std::vector<N>> GetConnected(const std::vector<N>& srcs);
+
+ private:
+  // Queries sent per frame, keeping each request well under the server's limit
+  static constexpr std::size_t kBatch = 4096;
+
+  const char* RoundTrip(const std::string& request);
+  // Reads an answer's status and throws Error{missing} if a node was missing. Returns false if
+  // the server had no room left in the frame, so this and later queries must be asked again.
+  template <typename Error>
+  bool Check(const char*& in, const char* end, const char* missing, bool first);
+
+  int fd_;
+  std::string response_;
+};
+
+/////////////////
+// QUERYSERVER //
+/////////////////
+
+template <typename N, typename E>
+gdwg::QueryServer<N, E>::QueryServer(const gdwg::SharedGraph<N, E>& g,
+                                     std::string path,
+                                     std::uint32_t max_response)
+  : g_{g}, path_{std::move(path)}, max_response_{max_response} {
+  auto addr = gdwg::detail::SocketAddress(path_, "QueryServer::QueryServer");
+  struct stat info;
+  if (::lstat(path_.c_str(), &info) == 0) {
+    if (!S_ISSOCK(info.st_mode)) {
+      throw std::runtime_error{"Cannot call QueryServer::QueryServer on " + path_ +
+                               ": it exists and is not a socket"};
+    }
+    ::unlink(path_.c_str());
+  }
+  listener_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listener_ < 0 || ::bind(listener_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(listener_, SOMAXCONN) != 0 || ::pipe(wake_) != 0) {
+    auto error = std::runtime_error{"Cannot call QueryServer::QueryServer on " + path_ + ": " +
+                                    std::strerror(errno)};
+    if (listener_ >= 0) {
+      ::close(listener_);
+    }
+    throw error;
+  }
+}
+
+template <typename N, typename E>
+gdwg::QueryServer<N, E>::~QueryServer() {
+  for (const auto& c : clients_) {
+    ::close(c.fd);
+  }
+  ::close(listener_);
+  ::close(wake_[0]);
+  ::close(wake_[1]);
+  ::unlink(path_.c_str());
+}
+
+template <typename N, typename E>
+void gdwg::QueryServer<N, E>::Stop() noexcept {
+  char byte = 0;
+  while (::write(wake_[1], &byte, 1) < 0 && errno == EINTR) {
+  }
+}
+
+template <typename N, typename E>
+void gdwg::QueryServer<N, E>::Run() {
+  std::vector<pollfd> fds;
+  while (true) {
+    fds.assign({{wake_[0], POLLIN, 0}, {listener_, POLLIN, 0}});
+    for (const auto& c : clients_) {
+      // A client isn't read from again until it has taken its answers
+      fds.push_back({c.fd, static_cast<short>(c.out.empty() ? POLLIN : POLLOUT), 0});
+    }
+    if (::poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error{std::string{"Cannot call QueryServer::Run: "} +
+                               std::strerror(errno)};
+    }
+    if (fds[0].revents != 0) {
+      char byte;
+      while (::read(wake_[0], &byte, 1) < 0 && errno == EINTR) {
+      }
+      return;
+    }
+    // Clients that hung up or sent something unreadable are dropped
+    for (std::size_t i = 0; i < clients_.size(); ++i) {
+      if (fds[i + 2].revents != 0 && !Serve(clients_[i], fds[i + 2].revents)) {
+        ::close(clients_[i].fd);
+        clients_[i].fd = -1;
+      }
+    }
+    clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                  [](const Connection& c) { return c.fd < 0; }),
+                   clients_.end());
+    if (fds[1].revents & POLLIN) {
+      auto fd = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd >= 0) {
+        clients_.push_back(Connection{fd, {}, {}, 0});
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+bool gdwg::QueryServer<N, E>::Serve(Connection& c, short revents) {
+  if (revents & POLLOUT) {
+    return Send(c) && Parse(c);
+  }
+  if (revents & (POLLERR | POLLNVAL)) {
+    return false;
+  }
+  auto start = c.in.size();
+  c.in.resize(start + gdwg::detail::kReceiveChunk);
+  auto got = ::recv(c.fd, &c.in[start], gdwg::detail::kReceiveChunk, 0);
+  auto error = errno;
+  c.in.resize(start + static_cast<std::size_t>(std::max<ssize_t>(got, 0)));
+  if (got < 0 && (error == EAGAIN || error == EWOULDBLOCK || error == EINTR)) {
+    return true;
+  }
+  if (got <= 0) {
+    return false;
+  }
+  return Parse(c);
+}
+
+template <typename N, typename E>
+bool gdwg::QueryServer<N, E>::Parse(Connection& c) {
+  std::size_t used = 0;
+  bool open = true;
+  // Answers are gathered up to a chunk at a time, and the next frame waits until they are sent
+  while (open && c.out.empty()) {
+    while (c.out.size() < gdwg::detail::kReceiveChunk &&
+           c.in.size() - used >= sizeof(std::uint32_t)) {
+      const char* in = c.in.data() + used;
+      std::uint32_t size;
+      Codec<std::uint32_t>::Decode(in, in + sizeof(std::uint32_t), size);
+      if (size > gdwg::detail::kMaxRequestFrame) {
+        return false;
+      }
+      // Keep a partial frame for the next read
+      if (c.in.size() - used - sizeof(std::uint32_t) < size) {
+        break;
+      }
+      auto header = c.out.size();
+      c.out.append(sizeof(std::uint32_t), '\0');
+      Answer(in, in + size, c.out);
+      std::string length;
+      Codec<std::uint32_t>::Encode(
+          length, static_cast<std::uint32_t>(c.out.size() - header - sizeof(std::uint32_t)));
+      c.out.replace(header, length.size(), length);
+      batches_.fetch_add(1, std::memory_order_relaxed);
+      used += sizeof(std::uint32_t) + size;
+    }
+    if (c.out.empty()) {
+      break;
+    }
+    open = Send(c);
+  }
+  c.in.erase(0, used);
+  return open;
+}
+
+template <typename N, typename E>
+bool gdwg::QueryServer<N, E>::Send(Connection& c) {
+  while (c.sent < c.out.size()) {
+    auto sent = ::send(c.fd, c.out.data() + c.sent, c.out.size() - c.sent, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    c.sent += static_cast<std::size_t>(sent);
+  }
+  c.out.clear();
+  c.sent = 0;
+  return true;
+}
+
+template <typename N, typename E>
+void gdwg::QueryServer<N, E>::Answer(const char* in, const char* end, std::string& response) {
+  auto status = [&response](QueryStatus s) {
+    Codec<std::uint8_t>::Encode(response, static_cast<std::uint8_t>(s));
+  };
+  auto body = response.size();
+  std::size_t queries = 0;
+  while (in != end) {
+    auto mark = response.size();
+    std::uint8_t op;
+    N src;
+    N dst;
+    Codec<std::uint8_t>::Decode(in, end, op);
+    if (!Codec<N>::Decode(in, end, src) ||
+        (op == static_cast<std::uint8_t>(QueryOp::kIsConnected) &&
+         !Codec<N>::Decode(in, end, dst))) {
+      // A truncated query ends the batch
+      status(QueryStatus::kBadRequest);
+      break;
+    }
+    if (op == static_cast<std::uint8_t>(QueryOp::kIsConnected)) {
+      if (!g_.IsNode(src) || !g_.IsNode(dst)) {
+        status(QueryStatus::kMissingNode);
+      } else {
+        status(QueryStatus::kOk);
+        Codec<std::uint8_t>::Encode(response, g_.IsConnected(src, dst) ? 1 : 0);
+      }
+    } else if (op == static_cast<std::uint8_t>(QueryOp::kGetConnected)) {
+      if (!g_.IsNode(src)) {
+        status(QueryStatus::kMissingNode);
+      } else {
+        status(QueryStatus::kOk);
+        auto connected = g_.GetConnected(src);
+        Codec<std::uint64_t>::Encode(response, connected.size());
+        for (const auto& node : connected) {
+          Codec<N>::Encode(response, node);
+        }
+      }
+    } else {
+      status(QueryStatus::kBadRequest);
+      break;
+    }
+    // The client asks again for whatever doesn't fit, leaving room for the kTooLarge byte
+    if (response.size() - body >= max_response_) {
+      response.resize(mark);
+      status(QueryStatus::kTooLarge);
+      break;
+    }
+    ++queries;
+  }
+  queries_.fetch_add(queries, std::memory_order_relaxed);
+}
+
+/////////////////
+// QUERYCLIENT //
+/////////////////
+
+template <typename N>
+gdwg::QueryClient<N>::QueryClient(const std::string& path) {
+  auto addr = gdwg::detail::SocketAddress(path, "QueryClient::QueryClient");
+  fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    auto error = std::runtime_error{"Cannot call QueryClient::QueryClient on " + path + ": " +
+                                    std::strerror(errno)};
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    throw error;
+  }
+}
+
+template <typename N>
+const char* gdwg::QueryClient<N>::RoundTrip(const std::string& request) {
+  if (!gdwg::detail::SendFrame(fd_, request) ||
+      !gdwg::detail::ReceiveFrame(fd_, response_, UINT32_MAX)) {
+    throw std::runtime_error{"Cannot call QueryClient after the connection was lost"};
+  }
+  return response_.data();
+}
+
+template <typename N>
+template <typename Error>
+bool gdwg::QueryClient<N>::Check(const char*& in,
+                                 const char* end,
+                                 const char* missing,
+                                 bool first) {
+  std::uint8_t status;
+  if (!Codec<std::uint8_t>::Decode(in, end, status) ||
+      status == static_cast<std::uint8_t>(QueryStatus::kBadRequest)) {
+    throw std::runtime_error{"Cannot call QueryClient with a malformed response"};
+  }
+  if (status == static_cast<std::uint8_t>(QueryStatus::kTooLarge)) {
+    // Asking again can't help if not even one answer fits
+    if (first) {
+      throw std::runtime_error{
+          "Cannot call QueryClient on a query whose answer is larger than a response frame"};
+    }
+    return false;
+  }
+  if (status == static_cast<std::uint8_t>(QueryStatus::kMissingNode)) {
+    throw Error{missing};
+  }
+  return true;
+}
+
+template <typename N>
+std::vector<bool> gdwg::QueryClient<N>::IsConnected(const std::vector<std::pair<N, N>>& pairs) {
+  std::vector<bool> answers;
+  answers.reserve(pairs.size());
+  for (std::size_t first = 0; first < pairs.size();) {
+    auto last = std::min(first + kBatch, pairs.size());
+    std::string request;
+    for (auto i = first; i < last; ++i) {
+      Codec<std::uint8_t>::Encode(request, static_cast<std::uint8_t>(QueryOp::kIsConnected));
+      Codec<N>::Encode(request, pairs[i].first);
+      Codec<N>::Encode(request, pairs[i].second);
+    }
+    const char* in = RoundTrip(request);
+    const char* end = in + response_.size();
+    auto i = first;
+    for (; i < last; ++i) {
+      if (!Check<std::runtime_error>(
+              in, end, "Cannot call Graph::IsConnected if src or dst node don't exist in the graph",
+              i == first)) {
+        break;
+      }
+      std::uint8_t connected;
+      if (!Codec<std::uint8_t>::Decode(in, end, connected)) {
+        throw std::runtime_error{"Cannot call QueryClient with a malformed response"};
+      }
+      answers.push_back(connected != 0);
+    }
+    first = i;
+  }
+  return answers;
+}
+
+template <typename N>
+std::vector<std::vector<N>> gdwg::QueryClient<N>::GetConnected(const std::vector<N>& srcs) {
+  std::vector<std::vector<N>> answers;
+  answers.reserve(srcs.size());
+  for (std::size_t first = 0; first < srcs.size();) {
+    auto last = std::min(first + kBatch, srcs.size());
+    std::string request;
+    for (auto i = first; i < last; ++i) {
+      Codec<std::uint8_t>::Encode(request, static_cast<std::uint8_t>(QueryOp::kGetConnected));
+      Codec<N>::Encode(request, srcs[i]);
+    }
+    const char* in = RoundTrip(request);
+    const char* end = in + response_.size();
+    auto i = first;
+    for (; i < last; ++i) {
+      if (!Check<std::out_of_range>(
+              in, end, "Cannot call Graph::GetConnected if src doesn't exist in the graph",
+              i == first)) {
+        break;
+      }
+      std::uint64_t count;
+      if (!Codec<std::uint64_t>::Decode(in, end, count) ||
+          static_cast<std::uint64_t>(end - in) / sizeof(N) < count) {
+        throw std::runtime_error{"Cannot call QueryClient with a malformed response"};
+      }
+      auto& connected = answers.emplace_back(static_cast<std::size_t>(count));
+      for (auto& node : connected) {
+        Codec<N>::Decode(in, end, node);
+      }
+    }
+    first = i;
+  }
+  return answers;
+}
+
+}  // namespace gdwg
+
+#endif  // ASSIGNMENTS_DG_QUERY_SERVER_H_
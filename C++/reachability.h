@@ -0,0 +1,66 @@
+#ifndef ASSIGNMENTS_DG_REACHABILITY_H_
+#define ASSIGNMENTS_DG_REACHABILITY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/algorithms.h"
+#include "assignments/dg/graph.h"
+#include "assignments/dg/packed_graph.h"
+
+namespace gdwg {
+
+// Answers transitive reachability from an index over the SCC condensation of a Graph.
+// Small condensations get a full bitset transitive closure, so a query is one bit test.
+// Larger ones get interval labels over spanning forests of the condensation. These rule
+// out most unreachable pairs in constant time, and the rest fall back to a search that the
+// labels and the topological numbering prune heavily.
+// The index is a snapshot: after the Graph changes, IsStale is true and IsReachable throws
+// until Rebuild is called. IsReachable is const and may be called from many threads at once;
+// Rebuild, like changing the Graph, must not overlap any query.
+template <typename N, typename E>
+class ReachabilityIndex {
+ public:
+  // Largest closure, in bytes, built before switching to interval labels
+  static constexpr std::size_t kDefaultClosureBudget = std::size_t{64} << 20;
+
+  explicit ReachabilityIndex(const gdwg::Graph<N, E>& g,
+                             std::size_t closure_budget = kDefaultClosureBudget);
+
+  bool IsReachable(const N& src, const N& dst) const;
+  bool IsStale() const noexcept { return version_ != graph_->Version(); }
+  void Rebuild();
+
+  std::size_t NumComponents() const noexcept { return num_components_; }
+  bool UsesClosure() const noexcept { return !closure_.empty(); }
+
+ private:
+  // Number of independent interval labellings
+  static constexpr std::size_t kLabels = 2;
+
+  bool Contains(std::size_t outer, std::size_t inner) const;
+  bool Search(std::size_t from, std::size_t to) const;
+
+  const gdwg::Graph<N, E>* graph_;
+  std::size_t closure_budget_;
+  std::size_t version_;
+
+  gdwg::PackedGraph<N, E> packed_;
+  std::vector<std::size_t> component_;
+  std::size_t num_components_ = 0;
+  std::vector<std::size_t> dag_offsets_;
+  std::vector<std::size_t> dag_targets_;
+
+  std::size_t row_words_ = 0;
+  std::vector<std::uint64_t> closure_;
+  // labels_[k * num_components_ + c] is component c's interval in labelling k
+  std::vector<std::pair<std::size_t, std::size_t>> labels_;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/reachability.tpp"
+
+#endif  // ASSIGNMENTS_DG_REACHABILITY_H_
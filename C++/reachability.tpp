@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//////////////////
+// CONSTRUCTORS //
+//////////////////
+
+template <typename N, typename E>
+gdwg::ReachabilityIndex<N, E>::ReachabilityIndex(const gdwg::Graph<N, E>& g,
+                                                 std::size_t closure_budget)
+  : graph_{&g}, closure_budget_{closure_budget}, version_{g.Version()} {
+  Rebuild();
+}
+
+/////////////
+// METHODS //
+/////////////
+
+template <typename N, typename E>
+void gdwg::ReachabilityIndex<N, E>::Rebuild() {
+  version_ = graph_->Version();
+  packed_ = gdwg::PackedGraph<N, E>{*graph_};
+  auto scc = gdwg::StronglyConnectedComponents(packed_);
+  component_ = std::move(scc.component);
+  num_components_ = scc.num_components;
+  dag_offsets_ = std::move(scc.dag_offsets);
+  dag_targets_ = std::move(scc.dag_targets);
+  closure_.clear();
+  labels_.clear();
+
+  auto count = num_components_;
+  row_words_ = (count + 63) / 64;
+  if (row_words_ * 8 * count <= closure_budget_) {
+    // Components are numbered topologically, so walking them backwards sees every
+    // successor's row before it is needed
+    closure_.assign(row_words_ * count, 0);
+    for (auto c = count; c-- > 0;) {
+      auto* row = closure_.data() + c * row_words_;
+      row[c / 64] |= std::uint64_t{1} << (c % 64);
+      for (auto i = dag_offsets_[c]; i < dag_offsets_[c + 1]; ++i) {
+        const auto* other = closure_.data() + dag_targets_[i] * row_words_;
+        for (std::size_t w = 0; w < row_words_; ++w) {
+          row[w] |= other[w];
+        }
+      }
+    }
+    return;
+  }
+
+  // Post-order intervals: if u reaches v then v's interval nests inside u's. Each labelling
+  // visits children in a different order so their false positives rarely coincide.
+  constexpr auto kUnlabelled = std::numeric_limits<std::size_t>::max();
+  labels_.assign(kLabels * count, {kUnlabelled, kUnlabelled});
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  for (std::size_t k = 0; k < kLabels; ++k) {
+    auto* label = labels_.data() + k * count;
+    auto child = [&](std::size_t c, std::size_t i) {
+      return k % 2 == 0 ? dag_targets_[dag_offsets_[c] + i]
+                        : dag_targets_[dag_offsets_[c + 1] - 1 - i];
+    };
+    std::size_t rank = 0;
+    for (std::size_t r = 0; r < count; ++r) {
+      auto root = k % 2 == 0 ? r : count - 1 - r;
+      if (label[root].first != kUnlabelled) {
+        continue;
+      }
+      stack.emplace_back(root, 0);
+      label[root].first = 0;
+      while (!stack.empty()) {
+        auto& [c, i] = stack.back();
+        if (i < dag_offsets_[c + 1] - dag_offsets_[c]) {
+          auto next = child(c, i++);
+          if (label[next].first == kUnlabelled) {
+            label[next].first = 0;
+            stack.emplace_back(next, 0);
+          }
+          continue;
+        }
+        auto low = rank;
+        for (auto j = dag_offsets_[c]; j < dag_offsets_[c + 1]; ++j) {
+          low = std::min(low, label[dag_targets_[j]].first);
+        }
+        label[c] = {low, rank++};
+        stack.pop_back();
+      }
+    }
+  }
+}
+
+template <typename N, typename E>
+bool gdwg::ReachabilityIndex<N, E>::IsReachable(const N& src, const N& dst) const {
+  if (IsStale()) {
+    throw std::runtime_error{
+        "Cannot call ReachabilityIndex::IsReachable after the graph changed; call Rebuild first"};
+  }
+  auto src_id = packed_.IndexOf(src);
+  auto dst_id = packed_.IndexOf(dst);
+  if (!src_id || !dst_id) {
+    throw std::out_of_range{
+        "Cannot call ReachabilityIndex::IsReachable if src or dst don't exist in the graph"};
+  }
+  auto from = component_[*src_id];
+  auto to = component_[*dst_id];
+  if (from == to) {
+    return true;
+  }
+  if (from > to) {
+    return false;
+  }
+  if (UsesClosure()) {
+    return (closure_[from * row_words_ + to / 64] >> (to % 64)) & 1U;
+  }
+  if (!Contains(from, to)) {
+    return false;
+  }
+  return Search(from, to);
+}
+
+template <typename N, typename E>
+bool gdwg::ReachabilityIndex<N, E>::Contains(std::size_t outer, std::size_t inner) const {
+  for (std::size_t k = 0; k < kLabels; ++k) {
+    const auto& a = labels_[k * num_components_ + outer];
+    const auto& b = labels_[k * num_components_ + inner];
+    if (b.first < a.first || b.second > a.second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Depth-first search over the condensation that only enters components which could still
+// reach the target by both topological number and interval labels
+template <typename N, typename E>
+bool gdwg::ReachabilityIndex<N, E>::Search(std::size_t from, std::size_t to) const {
+  // Per-thread marks, shared by every index and reset lazily by bumping the epoch: a mark only
+  // equals the epoch if this search set it
+  struct Scratch {
+    std::vector<std::size_t> seen;
+    std::vector<std::size_t> stack;
+    std::size_t epoch = 0;
+  };
+  thread_local Scratch scratch;
+  auto& seen = scratch.seen;
+  auto& stack = scratch.stack;
+  if (seen.size() < num_components_) {
+    seen.resize(num_components_, 0);
+  }
+  if (++scratch.epoch == 0) {
+    std::fill(seen.begin(), seen.end(), 0);
+    scratch.epoch = 1;
+  }
+  auto epoch = scratch.epoch;
+  stack.assign(1, from);
+  seen[from] = epoch;
+  while (!stack.empty()) {
+    auto c = stack.back();
+    stack.pop_back();
+    for (auto i = dag_offsets_[c]; i < dag_offsets_[c + 1]; ++i) {
+      auto next = dag_targets_[i];
+      if (next == to) {
+        return true;
+      }
+      if (next < to && seen[next] != epoch && Contains(next, to)) {
+        seen[next] = epoch;
+        stack.push_back(next);
+      }
+    }
+  }
+  return false;
+}
@@ -0,0 +1,137 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  The index is checked on a small graph with cycles where every answer is known, and then
+  compared with a plain BFS over GetConnected on a larger graph. Both the transitive closure
+  and the interval-label fallback are exercised by forcing a zero closure budget.
+
+  * IsReachable
+    - src or dst does not exist
+    - nodes in the same cycle, downstream, upstream and in separate islands
+    - the index notices graph changes and throws until it is rebuilt
+    - closure and interval labels agree with BFS on a larger graph, also when several threads
+      query one index at once
+
+*/
+
+#include "assignments/dg/reachability.h"
+
+#include <queue>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "catch.h"
+
+SCENARIO("Reachability queries on a small graph") {
+  GIVEN("A cycle feeding a chain, and a separate island") {
+    gdwg::Graph<std::string, int> g{"a", "b", "c", "d", "e", "x", "y"};
+    g.InsertEdge("a", "b", 1);
+    g.InsertEdge("b", "c", 1);
+    g.InsertEdge("c", "a", 1);
+    g.InsertEdge("c", "d", 1);
+    g.InsertEdge("d", "e", 1);
+    g.InsertEdge("x", "y", 1);
+    for (std::size_t budget : {gdwg::ReachabilityIndex<std::string, int>::kDefaultClosureBudget,
+                               std::size_t{0}}) {
+      gdwg::ReachabilityIndex<std::string, int> index{g, budget};
+      THEN("Unknown nodes throw") {
+        REQUIRE_THROWS_WITH(
+            index.IsReachable("a", "z"),
+            "Cannot call ReachabilityIndex::IsReachable if src or dst don't exist in the graph");
+      }
+      THEN("Reachability follows paths, not just direct edges") {
+        REQUIRE(index.UsesClosure() == (budget != 0));
+        REQUIRE(index.NumComponents() == 5);
+        REQUIRE(index.IsReachable("b", "a"));
+        REQUIRE(index.IsReachable("a", "e"));
+        REQUIRE(index.IsReachable("e", "e"));
+        REQUIRE(index.IsReachable("e", "a") == false);
+        REQUIRE(index.IsReachable("a", "y") == false);
+        REQUIRE(index.IsReachable("x", "y"));
+      }
+      WHEN("The graph changes") {
+        g.InsertEdge("e", "x", 1);
+        THEN("The index is stale and throws until it is rebuilt") {
+          REQUIRE(index.IsStale());
+          REQUIRE_THROWS_WITH(index.IsReachable("a", "y"),
+                              "Cannot call ReachabilityIndex::IsReachable after the graph "
+                              "changed; call Rebuild first");
+          index.Rebuild();
+          REQUIRE(index.IsStale() == false);
+          REQUIRE(index.IsReachable("a", "y"));
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Reachability agrees with BFS on a larger graph") {
+  GIVEN("A pseudo-random sparse graph") {
+    constexpr int kNodes = 400;
+    gdwg::Graph<int, int> g;
+    for (int i = 0; i < kNodes; ++i) {
+      g.InsertNode(i);
+    }
+    unsigned seed = 17;
+    for (int i = 0; i < 500; ++i) {
+      seed = seed * 1103515245 + 12345;
+      auto src = static_cast<int>((seed >> 8) % kNodes);
+      seed = seed * 1103515245 + 12345;
+      auto dst = static_cast<int>((seed >> 8) % kNodes);
+      g.InsertEdge(src, dst, 0);
+    }
+    gdwg::ReachabilityIndex<int, int> closure{g};
+    gdwg::ReachabilityIndex<int, int> labels{g, 0};
+    // expected[src][dst], by BFS over GetConnected
+    std::vector<std::vector<bool>> expected;
+    for (int src = 0; src < kNodes; ++src) {
+      std::set<int> seen{src};
+      std::queue<int> queue;
+      queue.push(src);
+      while (!queue.empty()) {
+        for (auto next : g.GetConnected(queue.front())) {
+          if (seen.insert(next).second) {
+            queue.push(next);
+          }
+        }
+        queue.pop();
+      }
+      auto& row = expected.emplace_back(kNodes, false);
+      for (auto dst : seen) {
+        row[static_cast<std::size_t>(dst)] = true;
+      }
+    }
+    THEN("Every pair matches") {
+      for (int src = 0; src < kNodes; src += 7) {
+        for (int dst = 0; dst < kNodes; ++dst) {
+          auto want = expected[static_cast<std::size_t>(src)][static_cast<std::size_t>(dst)];
+          REQUIRE(closure.IsReachable(src, dst) == want);
+          REQUIRE(labels.IsReachable(src, dst) == want);
+        }
+      }
+    }
+    THEN("Threads querying one index at once all get the right answers") {
+      const auto& shared = labels;
+      std::vector<int> wrong(4, 0);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+          for (int src = t; src < kNodes; src += 4) {
+            for (int dst = 0; dst < kNodes; ++dst) {
+              auto want = expected[static_cast<std::size_t>(src)][static_cast<std::size_t>(dst)];
+              wrong[static_cast<std::size_t>(t)] += shared.IsReachable(src, dst) != want;
+            }
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      REQUIRE(wrong == std::vector<int>(4, 0));
+    }
+  }
+}
@@ -0,0 +1,158 @@
+#ifndef ASSIGNMENTS_DG_SHARED_GRAPH_H_
+#define ASSIGNMENTS_DG_SHARED_GRAPH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+
+namespace gdwg {
+
+namespace detail {
+
+// Start of a shared graph segment. Arrays are found by their byte offset from the start of
+// the segment, never by address, so every process can map it wherever it likes.
+struct SharedHeader {
+  char magic[8];
+  std::uint32_t format;
+  std::uint32_t node_size;
+  std::uint32_t edge_size;
+  std::uint32_t reserved;
+  std::uint64_t bytes;
+  std::uint64_t num_nodes;
+  std::uint64_t num_slots;
+  std::uint64_t num_edges;
+  std::uint64_t nodes_at;
+  std::uint64_t offsets_at;
+  std::uint64_t targets_at;
+  std::uint64_t weight_offsets_at;
+  std::uint64_t weights_at;
+};
+
+}  // namespace detail
+
+// Read-only Graph laid out in a POSIX shared-memory segment, so processes on one host can share
+// one copy instead of each holding their own. One process builds it with Create; others map
+// the same pages with Attach and query them in place.
+// The layout is PackedGraph's: nodes sorted by N, each node's distinct out-neighbours as a
+// sorted run of ids, and each (src, dst) pair's weights as a sorted run. Values are stored byte
+// for byte, so N and E must be trivially copyable and readers must be built for the same
+// platform as the writer.
+// The segment is removed from the namespace when the SharedGraph that created it is destroyed.
+// Processes still attached keep their mapping.
+template <typename N, typename E>
+class SharedGraph {
+  static_assert(std::is_trivially_copyable_v<N> && std::is_trivially_copyable_v<E>,
+                "SharedGraph stores nodes and weights byte for byte");
+
+ public:
+  using NodeId = std::uint32_t;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::tuple<N, N, E>;
+    using reference = std::tuple<const N&, const N&, const E&>;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    const_iterator& operator++();
+    const_iterator operator++(int) {
+      auto copy{*this};
+      ++(*this);
+      return copy;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.weight_ == rhs.weight_;
+    }
+    friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class SharedGraph;
+    const_iterator(const SharedGraph* g, std::size_t weight);
+
+    const SharedGraph* g_ = nullptr;
+    std::size_t src_ = 0;
+    std::size_t slot_ = 0;
+    std::size_t weight_ = 0;
+  };
+
+  // Builds g into a new segment called name ("/something"), which must not already exist
+  static SharedGraph Create(const std::string& name, const gdwg::Graph<N, E>& g);
+  // Maps an existing segment read-only. Throws if it doesn't exist, isn't finished, or was
+  // written for different N or E.
+  static SharedGraph Attach(const std::string& name);
+
+  SharedGraph(SharedGraph&& g) noexcept;
+  SharedGraph& operator=(SharedGraph&& g) noexcept;
+  SharedGraph(const SharedGraph&) = delete;
+  SharedGraph& operator=(const SharedGraph&) = delete;
+  ~SharedGraph();
+
+  // The same queries as Graph, with the same errors
+  bool IsNode(const N& val) const { return IndexOf(val).has_value(); }
+  bool IsConnected(const N& src, const N& dst) const;
+  std::vector<N> GetNodes() const;
+  std::vector<N> GetConnected(const N& src) const;
+  std::vector<E> GetWeights(const N& src, const N& dst) const;
+  std::size_t OutDegree(const N& src) const;
+  std::size_t size() const noexcept { return header_->num_nodes; }
+  bool empty() const noexcept { return size() == 0; }
+  std::size_t NumEdges() const noexcept { return header_->num_edges; }
+
+  // Edges as (src, dst, weight) in the order Graph iterates them
+  const_iterator cbegin() const { return const_iterator{this, 0}; }
+  const_iterator cend() const { return const_iterator{this, NumEdges()}; }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+
+  std::optional<NodeId> IndexOf(const N& val) const;
+  const std::string& Name() const noexcept { return name_; }
+  // Size of the mapping
+  std::size_t Bytes() const noexcept { return bytes_; }
+  bool IsOwner() const noexcept { return owner_; }
+
+ private:
+  SharedGraph(std::string name, void* base, std::size_t bytes, bool owner) noexcept;
+
+  template <typename T>
+  const T* Array(std::uint64_t at) const noexcept {
+    return reinterpret_cast<const T*>(static_cast<const char*>(base_) + at);
+  }
+  const N* Nodes() const noexcept { return Array<N>(header_->nodes_at); }
+  const std::uint64_t* Offsets() const noexcept {
+    return Array<std::uint64_t>(header_->offsets_at);
+  }
+  const NodeId* Targets() const noexcept { return Array<NodeId>(header_->targets_at); }
+  const std::uint64_t* WeightOffsets() const noexcept {
+    return Array<std::uint64_t>(header_->weight_offsets_at);
+  }
+  const E* Weights() const noexcept { return Array<E>(header_->weights_at); }
+  // Slot of (src, dst) in src's run, if they are connected
+  std::optional<std::size_t> Slot(NodeId src, NodeId dst) const;
+  void Release() noexcept;
+
+  std::string name_;
+  void* base_ = nullptr;
+  const gdwg::detail::SharedHeader* header_ = nullptr;
+  std::size_t bytes_ = 0;
+  bool owner_ = false;
+};
+
+}  // namespace gdwg
+
+#include "assignments/dg/shared_graph.tpp"
+
+#endif  // ASSIGNMENTS_DG_SHARED_GRAPH_H_
@@ -0,0 +1,331 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/packed_graph.h"
+
+namespace gdwg {
+namespace detail {
+
+constexpr char kSharedMagic[8] = {'G', 'D', 'W', 'G', 'S', 'H', 'M', '\0'};
+constexpr std::uint32_t kSharedFormat = 1;
+
+// Arrays start on cache-line boundaries
+inline std::uint64_t AlignUp(std::uint64_t at) noexcept {
+  return (at + 63) & ~std::uint64_t{63};
+}
+
+inline std::runtime_error SharedError(const char* what, const std::string& name) {
+  return std::runtime_error{std::string{"Cannot call SharedGraph::"} + what + " on " + name +
+                            ": " + std::strerror(errno)};
+}
+
+}  // namespace detail
+}  // namespace gdwg
+
+//////////////////
+// CONSTRUCTORS //
+//////////////////
+
+template <typename N, typename E>
+gdwg::SharedGraph<N, E>::SharedGraph(std::string name,
+                                     void* base,
+                                     std::size_t bytes,
+                                     bool owner) noexcept
+  : name_{std::move(name)}, base_{base},
+    header_{static_cast<const gdwg::detail::SharedHeader*>(base)}, bytes_{bytes}, owner_{owner} {}
+
+template <typename N, typename E>
+gdwg::SharedGraph<N, E> gdwg::SharedGraph<N, E>::Create(const std::string& name,
+                                                        const gdwg::Graph<N, E>& g) {
+  gdwg::PackedGraph<N, E> packed{g};
+  gdwg::detail::SharedHeader header{};
+  std::memcpy(header.magic, gdwg::detail::kSharedMagic, sizeof(header.magic));
+  header.format = gdwg::detail::kSharedFormat;
+  header.node_size = sizeof(N);
+  header.edge_size = sizeof(E);
+  header.num_nodes = packed.NumNodes();
+  header.num_slots = packed.Targets().size();
+  header.num_edges = packed.NumEdges();
+  std::uint64_t at = sizeof(header);
+  auto place = [&at](std::uint64_t& field, std::uint64_t size) {
+    field = at = gdwg::detail::AlignUp(at);
+    at += size;
+  };
+  place(header.nodes_at, header.num_nodes * sizeof(N));
+  place(header.offsets_at, (header.num_nodes + 1) * sizeof(std::uint64_t));
+  place(header.targets_at, header.num_slots * sizeof(NodeId));
+  place(header.weight_offsets_at, (header.num_slots + 1) * sizeof(std::uint64_t));
+  place(header.weights_at, header.num_edges * sizeof(E));
+  header.bytes = at;
+
+  auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    throw gdwg::detail::SharedError("Create", name);
+  }
+  void* base = MAP_FAILED;
+  if (::ftruncate(fd, static_cast<off_t>(header.bytes)) == 0) {
+    base = ::mmap(nullptr, header.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (base == MAP_FAILED) {
+    auto error = gdwg::detail::SharedError("Create", name);
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    throw error;
+  }
+  ::close(fd);
+  // Owned from here on, so a throw below unmaps and unlinks it
+  SharedGraph shared{name, base, header.bytes, true};
+
+  auto* bytes = static_cast<char*>(base);
+  auto copy = [bytes](std::uint64_t at, const auto& vec) {
+    using T = typename std::decay_t<decltype(vec)>::value_type;
+    std::copy(vec.begin(), vec.end(), reinterpret_cast<T*>(bytes + at));
+  };
+  copy(header.nodes_at, packed.Nodes());
+  std::vector<std::uint64_t> offsets(packed.Offsets().begin(), packed.Offsets().end());
+  copy(header.offsets_at, offsets);
+  copy(header.targets_at, packed.Targets());
+  offsets.assign(packed.WeightOffsets().begin(), packed.WeightOffsets().end());
+  copy(header.weight_offsets_at, offsets);
+  copy(header.weights_at, packed.Weights());
+
+  // The magic goes in last, so a reader never sees a half-written segment as finished
+  auto unfinished = header;
+  std::memset(unfinished.magic, 0, sizeof(unfinished.magic));
+  std::memcpy(bytes, &unfinished, sizeof(unfinished));
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(bytes, gdwg::detail::kSharedMagic, sizeof(header.magic));
+  return shared;
+}
+
+template <typename N, typename E>
+gdwg::SharedGraph<N, E> gdwg::SharedGraph<N, E>::Attach(const std::string& name) {
+  auto fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw gdwg::detail::SharedError("Attach", name);
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    auto error = gdwg::detail::SharedError("Attach", name);
+    ::close(fd);
+    throw error;
+  }
+  auto bytes = static_cast<std::size_t>(info.st_size);
+  if (bytes < sizeof(gdwg::detail::SharedHeader)) {
+    ::close(fd);
+    throw std::runtime_error{"Cannot call SharedGraph::Attach on " + name +
+                             ": it is not a finished shared graph"};
+  }
+  auto* base = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    auto error = gdwg::detail::SharedError("Attach", name);
+    ::close(fd);
+    throw error;
+  }
+  ::close(fd);
+  SharedGraph shared{name, base, bytes, false};
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto& header = *shared.header_;
+  if (std::memcmp(header.magic, gdwg::detail::kSharedMagic, sizeof(header.magic)) != 0 ||
+      header.format != gdwg::detail::kSharedFormat || header.bytes > shared.bytes_) {
+    throw std::runtime_error{"Cannot call SharedGraph::Attach on " + name +
+                             ": it is not a finished shared graph"};
+  }
+  if (header.node_size != sizeof(N) || header.edge_size != sizeof(E)) {
+    throw std::runtime_error{"Cannot call SharedGraph::Attach on " + name +
+                             ": it was written for different node or edge types"};
+  }
+  // Every array must be aligned and lie inside the segment, checked without overflowing on
+  // huge counts. A wrapped num_nodes + 1 or num_slots + 1 is caught by the array before it.
+  auto fits = [&header](std::uint64_t at, std::uint64_t count, std::size_t size,
+                        std::size_t align) {
+    return at >= sizeof(header) && at % align == 0 && at <= header.bytes &&
+           count <= (header.bytes - at) / size;
+  };
+  if (!fits(header.nodes_at, header.num_nodes, sizeof(N), alignof(N)) ||
+      !fits(header.offsets_at, header.num_nodes + 1, sizeof(std::uint64_t),
+            alignof(std::uint64_t)) ||
+      !fits(header.targets_at, header.num_slots, sizeof(NodeId), alignof(NodeId)) ||
+      !fits(header.weight_offsets_at, header.num_slots + 1, sizeof(std::uint64_t),
+            alignof(std::uint64_t)) ||
+      !fits(header.weights_at, header.num_edges, sizeof(E), alignof(E))) {
+    throw std::runtime_error{"Cannot call SharedGraph::Attach on " + name +
+                             ": it is not a finished shared graph"};
+  }
+  return shared;
+}
+
+template <typename N, typename E>
+gdwg::SharedGraph<N, E>::SharedGraph(SharedGraph&& g) noexcept
+  : name_{std::move(g.name_)}, base_{g.base_}, header_{g.header_}, bytes_{g.bytes_},
+    owner_{g.owner_} {
+  g.base_ = nullptr;
+  g.header_ = nullptr;
+  g.owner_ = false;
+}
+
+template <typename N, typename E>
+gdwg::SharedGraph<N, E>& gdwg::SharedGraph<N, E>::operator=(SharedGraph&& g) noexcept {
+  if (this != &g) {
+    Release();
+    name_ = std::move(g.name_);
+    base_ = std::exchange(g.base_, nullptr);
+    header_ = std::exchange(g.header_, nullptr);
+    bytes_ = g.bytes_;
+    owner_ = std::exchange(g.owner_, false);
+  }
+  return *this;
+}
+
+template <typename N, typename E>
+gdwg::SharedGraph<N, E>::~SharedGraph() {
+  Release();
+}
+
+template <typename N, typename E>
+void gdwg::SharedGraph<N, E>::Release() noexcept {
+  if (base_ != nullptr) {
+    ::munmap(base_, bytes_);
+    base_ = nullptr;
+    header_ = nullptr;
+  }
+  if (owner_) {
+    ::shm_unlink(name_.c_str());
+    owner_ = false;
+  }
+}
+
+/////////////
+// METHODS //
+/////////////
+
+template <typename N, typename E>
+std::optional<typename gdwg::SharedGraph<N, E>::NodeId>
+gdwg::SharedGraph<N, E>::IndexOf(const N& val) const {
+  const auto* begin = Nodes();
+  const auto* end = begin + size();
+  const auto* it = std::lower_bound(begin, end, val);
+  if (it == end || val < *it) {
+    return std::nullopt;
+  }
+  return static_cast<NodeId>(it - begin);
+}
+
+template <typename N, typename E>
+std::optional<std::size_t> gdwg::SharedGraph<N, E>::Slot(NodeId src, NodeId dst) const {
+  const auto* begin = Targets() + Offsets()[src];
+  const auto* end = Targets() + Offsets()[src + 1];
+  const auto* it = std::lower_bound(begin, end, dst);
+  if (it == end || *it != dst) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(it - Targets());
+}
+
+template <typename N, typename E>
+bool gdwg::SharedGraph<N, E>::IsConnected(const N& src, const N& dst) const {
+  auto src_id = IndexOf(src);
+  auto dst_id = IndexOf(dst);
+  if (!src_id || !dst_id) {
+    throw std::runtime_error{
+        "Cannot call Graph::IsConnected if src or dst node don't exist in the graph"};
+  }
+  return Slot(*src_id, *dst_id).has_value();
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::SharedGraph<N, E>::GetNodes() const {
+  return std::vector<N>(Nodes(), Nodes() + size());
+}
+
+template <typename N, typename E>
+std::vector<N> gdwg::SharedGraph<N, E>::GetConnected(const N& src) const {
+  auto id = IndexOf(src);
+  if (!id) {
+    throw std::out_of_range{"Cannot call Graph::GetConnected if src doesn't exist in the graph"};
+  }
+  std::vector<N> vec;
+  vec.reserve(Offsets()[*id + 1] - Offsets()[*id]);
+  for (auto slot = Offsets()[*id]; slot < Offsets()[*id + 1]; ++slot) {
+    vec.push_back(Nodes()[Targets()[slot]]);
+  }
+  return vec;
+}
+
+template <typename N, typename E>
+std::vector<E> gdwg::SharedGraph<N, E>::GetWeights(const N& src, const N& dst) const {
+  auto src_id = IndexOf(src);
+  auto dst_id = IndexOf(dst);
+  if (!src_id || !dst_id) {
+    throw std::out_of_range{
+        "Cannot call Graph::GetWeights if src or dst node don't exist in the graph"};
+  }
+  auto slot = Slot(*src_id, *dst_id);
+  if (!slot) {
+    return {};
+  }
+  return std::vector<E>(Weights() + WeightOffsets()[*slot], Weights() + WeightOffsets()[*slot + 1]);
+}
+
+template <typename N, typename E>
+std::size_t gdwg::SharedGraph<N, E>::OutDegree(const N& src) const {
+  auto id = IndexOf(src);
+  if (!id) {
+    throw std::out_of_range{"Cannot call Graph::OutDegree if src doesn't exist in the graph"};
+  }
+  return WeightOffsets()[Offsets()[*id + 1]] - WeightOffsets()[Offsets()[*id]];
+}
+
+///////////////
+// ITERATORS //
+///////////////
+
+// An iterator is its position in the weights array; the slot and src are found from it once
+// and then advanced alongside
+template <typename N, typename E>
+gdwg::SharedGraph<N, E>::const_iterator::const_iterator(const SharedGraph* g, std::size_t weight)
+  : g_{g}, weight_{weight} {
+  if (weight_ == g_->NumEdges()) {
+    return;
+  }
+  const auto* weight_offsets = g_->WeightOffsets();
+  slot_ = static_cast<std::size_t>(
+      std::upper_bound(weight_offsets, weight_offsets + g_->header_->num_slots + 1, weight_) -
+      weight_offsets - 1);
+  const auto* offsets = g_->Offsets();
+  src_ = static_cast<std::size_t>(
+      std::upper_bound(offsets, offsets + g_->size() + 1, slot_) - offsets - 1);
+}
+
+template <typename N, typename E>
+typename gdwg::SharedGraph<N, E>::const_iterator::reference
+gdwg::SharedGraph<N, E>::const_iterator::operator*() const {
+  return {g_->Nodes()[src_], g_->Nodes()[g_->Targets()[slot_]], g_->Weights()[weight_]};
+}
+
+template <typename N, typename E>
+typename gdwg::SharedGraph<N, E>::const_iterator&
+gdwg::SharedGraph<N, E>::const_iterator::operator++() {
+  ++weight_;
+  if (weight_ == g_->NumEdges()) {
+    return *this;
+  }
+  while (g_->WeightOffsets()[slot_ + 1] <= weight_) {
+    ++slot_;
+  }
+  while (g_->Offsets()[src_ + 1] <= slot_) {
+    ++src_;
+  }
+  return *this;
+}
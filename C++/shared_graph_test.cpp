@@ -0,0 +1,390 @@
+/*
+
+  == Explanation and rational of testing ==
+
+  A SharedGraph must answer every read exactly as the Graph it was built from, so each query is
+  compared with the Graph over all pairs of nodes of a small graph with parallel edges, a self
+  loop, an isolated node and a deleted node. Sharing between processes is checked for real: a
+  forked child attaches by name and checks what it sees, reporting through its exit status.
+  * SharedGraph
+    - every query and the iteration order agree with the Graph, including its exceptions
+    - an attached copy agrees too, from this process and from a child process
+    - names already in use, missing segments, different node or edge types and headers
+      whose arrays run past the segment throw
+    - readers keep their mapping after the owner has gone, but no new reader can attach
+    - the empty graph
+  * QueryServer and QueryClient
+    - batched IsConnected and GetConnected agree with the Graph, across several frames
+    - a missing node throws Graph's exception, and the connection stays usable
+    - several clients are served at once and the server stops on request
+    - a client that stalls mid-frame, or never reads a large answer, holds up nobody else
+    - a client that never reads only has a bounded amount of answers queued for it
+    - answers too big for one response frame are split across frames, and a single answer
+      too big for a frame throws
+    - a server won't replace a file at its path that isn't a socket
+
+*/
+
+#include "assignments/dg/shared_graph.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "assignments/dg/graph.h"
+#include "assignments/dg/query_server.h"
+#include "catch.h"
+
+namespace {
+
+using Shared = gdwg::SharedGraph<int, double>;
+using OtherShared = gdwg::SharedGraph<int, float>;
+
+// Names are unique to the process so parallel test runs can't collide
+std::string Unique(const std::string& stem) {
+  return stem + std::to_string(::getpid());
+}
+
+// A connection that speaks the wire format by hand, to misbehave
+int Connect(const std::string& path) {
+  auto addr = gdwg::detail::SocketAddress(path, "Connect");
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+  return fd;
+}
+
+void Fill(gdwg::Graph<int, double>& g) {
+  for (int i = 0; i < 8; ++i) {
+    g.InsertNode(i * 3);
+  }
+  g.InsertEdge(0, 3, 1.5);
+  g.InsertEdge(0, 3, -2.0);
+  g.InsertEdge(0, 21, 4.0);
+  g.InsertEdge(3, 3, 0.0);
+  g.InsertEdge(6, 0, 7.0);
+  g.InsertEdge(9, 6, 1.0);
+  g.InsertEdge(9, 15, 2.0);
+  g.InsertEdge(15, 9, 3.0);
+  g.InsertEdge(18, 0, 1.0);
+  g.DeleteNode(18);
+}
+
+template <typename G>
+bool SameAsGraph(gdwg::Graph<int, double>& g, const G& shared) {
+  using Edges = std::vector<std::tuple<int, int, double>>;
+  if (shared.size() != g.size() || shared.NumEdges() != g.NumEdges() ||
+      shared.GetNodes() != g.GetNodes() ||
+      Edges(shared.cbegin(), shared.cend()) != Edges(g.cbegin(), g.cend())) {
+    return false;
+  }
+  for (int src = -1; src < 24; ++src) {
+    if (shared.IsNode(src) != g.IsNode(src)) {
+      return false;
+    }
+    if (!g.IsNode(src)) {
+      continue;
+    }
+    if (shared.GetConnected(src) != g.GetConnected(src) ||
+        shared.OutDegree(src) != g.OutDegree(src)) {
+      return false;
+    }
+    for (auto dst : g.GetNodes()) {
+      if (shared.IsConnected(src, dst) != g.IsConnected(src, dst) ||
+          shared.GetWeights(src, dst) != g.GetWeights(src, dst)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+SCENARIO("Sharing a graph between processes") {
+  GIVEN("A graph built into a shared segment") {
+    gdwg::Graph<int, double> g;
+    Fill(g);
+    auto name = Unique("/gdwg_shared_test_");
+    auto shared = Shared::Create(name, g);
+
+    THEN("It answers every query as the graph does") {
+      REQUIRE(shared.IsOwner());
+      REQUIRE(SameAsGraph(g, shared));
+      REQUIRE_THROWS_WITH(
+          shared.IsConnected(0, 18),
+          "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+      REQUIRE_THROWS_WITH(shared.GetConnected(1),
+                          "Cannot call Graph::GetConnected if src doesn't exist in the graph");
+      REQUIRE_THROWS_WITH(
+          shared.GetWeights(1, 0),
+          "Cannot call Graph::GetWeights if src or dst node don't exist in the graph");
+      REQUIRE_THROWS_AS(shared.IsConnected(1, 0), std::runtime_error);
+      REQUIRE_THROWS_AS(shared.GetConnected(1), std::out_of_range);
+      REQUIRE_THROWS_AS(shared.OutDegree(1), std::out_of_range);
+    }
+
+    WHEN("The same process attaches to it") {
+      auto reader = Shared::Attach(name);
+      THEN("The reader sees the same graph") {
+        REQUIRE_FALSE(reader.IsOwner());
+        REQUIRE(SameAsGraph(g, reader));
+      }
+      THEN("The reader keeps working after the owner is gone") {
+        { auto owner = std::move(shared); }
+        REQUIRE(SameAsGraph(g, reader));
+        REQUIRE_THROWS_AS(Shared::Attach(name), std::runtime_error);
+      }
+    }
+
+    WHEN("A child process attaches to it") {
+      auto child = ::fork();
+      if (child == 0) {
+        try {
+          auto reader = Shared::Attach(name);
+          ::_exit(SameAsGraph(g, reader) ? 0 : 1);
+        } catch (...) {
+          ::_exit(2);
+        }
+      }
+      int status = 0;
+      ::waitpid(child, &status, 0);
+      THEN("The child sees the same graph") {
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+      }
+    }
+
+    WHEN("It is misused") {
+      THEN("It throws") {
+        REQUIRE_THROWS_AS(Shared::Create(name, g), std::runtime_error);
+        REQUIRE_THROWS_AS(Shared::Attach(name + "_missing"), std::runtime_error);
+        REQUIRE_THROWS_WITH(OtherShared::Attach(name),
+                            "Cannot call SharedGraph::Attach on " + name +
+                                ": it was written for different node or edge types");
+      }
+      THEN("A segment whose header claims arrays past its end is refused") {
+        gdwg::detail::SharedHeader header{};
+        std::memcpy(header.magic, gdwg::detail::kSharedMagic, sizeof(header.magic));
+        header.format = gdwg::detail::kSharedFormat;
+        header.node_size = sizeof(int);
+        header.edge_size = sizeof(double);
+        header.bytes = sizeof(header);
+        for (auto num_nodes : {std::uint64_t{1} << 40, UINT64_MAX}) {
+          header.num_nodes = num_nodes;
+          for (auto* at : {&header.nodes_at, &header.offsets_at, &header.targets_at,
+                           &header.weight_offsets_at, &header.weights_at}) {
+            *at = sizeof(header);
+          }
+          auto corrupt = name + "_corrupt";
+          auto fd = ::shm_open(corrupt.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+          REQUIRE(::write(fd, &header, sizeof(header)) == sizeof(header));
+          ::close(fd);
+          REQUIRE_THROWS_WITH(Shared::Attach(corrupt), "Cannot call SharedGraph::Attach on " +
+                                                           corrupt +
+                                                           ": it is not a finished shared graph");
+          ::shm_unlink(corrupt.c_str());
+        }
+      }
+    }
+  }
+
+  GIVEN("An empty graph") {
+    gdwg::Graph<int, double> g;
+    auto shared = Shared::Create(Unique("/gdwg_shared_empty_"), g);
+    THEN("The shared graph is empty") {
+      REQUIRE(shared.empty());
+      REQUIRE(shared.cbegin() == shared.cend());
+      REQUIRE_FALSE(shared.IsNode(0));
+    }
+  }
+}
+
+SCENARIO("Querying a shared graph over a socket") {
+  GIVEN("A server for a shared graph") {
+    gdwg::Graph<int, double> g;
+    Fill(g);
+    auto shared = Shared::Create(Unique("/gdwg_query_test_"), g);
+    auto path = "/tmp/" + Unique("gdwg_query_test_") + ".sock";
+    gdwg::QueryServer<int, double> server{shared, path};
+    std::thread runner{[&server] { server.Run(); }};
+
+    WHEN("Clients send batches") {
+      gdwg::QueryClient<int> client{path};
+      gdwg::QueryClient<int> other{path};
+      std::vector<std::pair<int, int>> pairs;
+      std::vector<bool> expected;
+      // Enough queries to need more than one frame
+      for (int round = 0; round < 100; ++round) {
+        for (auto src : g.GetNodes()) {
+          for (auto dst : g.GetNodes()) {
+            pairs.emplace_back(src, dst);
+            expected.push_back(g.IsConnected(src, dst));
+          }
+        }
+      }
+      auto answers = client.IsConnected(pairs);
+      auto connected = other.GetConnected(g.GetNodes());
+
+      THEN("They get the graph's answers") {
+        REQUIRE(answers == expected);
+        auto nodes = g.GetNodes();
+        REQUIRE(connected.size() == nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+          REQUIRE(connected[i] == g.GetConnected(nodes[i]));
+        }
+        REQUIRE(server.Batches() == 3);
+        REQUIRE(server.Queries() == pairs.size() + nodes.size());
+      }
+
+      THEN("A missing node throws and the connection stays usable") {
+        REQUIRE_THROWS_WITH(
+            client.IsConnected({{0, 3}, {0, 18}}),
+            "Cannot call Graph::IsConnected if src or dst node don't exist in the graph");
+        REQUIRE_THROWS_WITH(client.GetConnected({1}),
+                            "Cannot call Graph::GetConnected if src doesn't exist in the graph");
+        REQUIRE_THROWS_AS(client.GetConnected({0, 1}), std::out_of_range);
+        REQUIRE(client.IsConnected({{0, 3}, {3, 0}}) == std::vector<bool>{true, false});
+      }
+    }
+
+    WHEN("One client stalls mid-frame and another never reads its answers") {
+      int stalled = Connect(path);
+      REQUIRE(::send(stalled, "\x10\x00", 2, 0) == 2);
+      // Answers far bigger than the socket buffers
+      std::string request;
+      for (int i = 0; i < 1000000; ++i) {
+        gdwg::Codec<std::uint8_t>::Encode(request,
+                                          static_cast<std::uint8_t>(gdwg::QueryOp::kIsConnected));
+        gdwg::Codec<int>::Encode(request, 0);
+        gdwg::Codec<int>::Encode(request, 3);
+      }
+      int deaf = Connect(path);
+      REQUIRE(gdwg::detail::SendFrame(deaf, request));
+      gdwg::QueryClient<int> client{path};
+      THEN("Other clients are still answered") {
+        REQUIRE(client.IsConnected({{0, 3}, {3, 0}}) == std::vector<bool>{true, false});
+        REQUIRE(client.GetConnected({9}) == std::vector<std::vector<int>>{{6, 15}});
+      }
+      ::close(stalled);
+      ::close(deaf);
+    }
+
+    server.Stop();
+    runner.join();
+  }
+
+  GIVEN("A server for a graph with a hub") {
+    gdwg::Graph<int, double> g;
+    for (int i = 0; i <= 4000; ++i) {
+      g.InsertNode(i);
+      g.InsertEdge(0, i, 1.0);
+    }
+    auto shared = Shared::Create(Unique("/gdwg_query_hub_"), g);
+    auto path = "/tmp/" + Unique("gdwg_query_hub_") + ".sock";
+    gdwg::QueryServer<int, double> server{shared, path};
+    std::thread runner{[&server] { server.Run(); }};
+
+    WHEN("A client that never reads sends thousands of tiny frames asking for the hub") {
+      std::string frames;
+      for (int i = 0; i < 20000; ++i) {
+        gdwg::Codec<std::uint32_t>::Encode(frames, 5);
+        gdwg::Codec<std::uint8_t>::Encode(frames,
+                                          static_cast<std::uint8_t>(gdwg::QueryOp::kGetConnected));
+        gdwg::Codec<int>::Encode(frames, 0);
+      }
+      int deaf = Connect(path);
+      std::size_t sent = 0;
+      while (sent < frames.size()) {
+        auto n = ::send(deaf, frames.data() + sent, frames.size() - sent, MSG_DONTWAIT);
+        if (n <= 0) {
+          break;
+        }
+        sent += static_cast<std::size_t>(n);
+      }
+      gdwg::QueryClient<int> client{path};
+      THEN("Only a few of its 16 KB answers are queued before it is read from again") {
+        REQUIRE(client.IsConnected({{0, 1}, {1, 0}}) == std::vector<bool>{true, false});
+        REQUIRE(sent > 1000);
+        REQUIRE(server.Batches() < 100);
+      }
+      ::close(deaf);
+    }
+
+    server.Stop();
+    runner.join();
+  }
+
+  GIVEN("A server with a small response frame") {
+    gdwg::Graph<int, double> g;
+    Fill(g);
+    auto shared = Shared::Create(Unique("/gdwg_query_small_"), g);
+    auto path = "/tmp/" + Unique("gdwg_query_small_") + ".sock";
+    // Room for one answer of two neighbours, but not two
+    gdwg::QueryServer<int, double> server{shared, path, 24};
+    std::thread runner{[&server] { server.Run(); }};
+    gdwg::QueryClient<int> client{path};
+
+    THEN("Answers are split across as many frames as they need") {
+      auto nodes = g.GetNodes();
+      auto connected = client.GetConnected(nodes);
+      REQUIRE(connected.size() == nodes.size());
+      for (std::size_t i = 0; i < nodes.size(); ++i) {
+        REQUIRE(connected[i] == g.GetConnected(nodes[i]));
+      }
+      REQUIRE(server.Batches() > 1);
+      REQUIRE(server.Queries() == nodes.size());
+    }
+
+    server.Stop();
+    runner.join();
+  }
+
+  GIVEN("A server whose response frame can't hold some answers") {
+    gdwg::Graph<int, double> g;
+    Fill(g);
+    auto shared = Shared::Create(Unique("/gdwg_query_tiny_"), g);
+    auto path = "/tmp/" + Unique("gdwg_query_tiny_") + ".sock";
+    gdwg::QueryServer<int, double> server{shared, path, 14};
+    std::thread runner{[&server] { server.Run(); }};
+    gdwg::QueryClient<int> client{path};
+
+    THEN("Those queries throw and smaller ones still work") {
+      REQUIRE_THROWS_WITH(
+          client.GetConnected({0}),
+          "Cannot call QueryClient on a query whose answer is larger than a response frame");
+      REQUIRE(client.GetConnected({3}) == std::vector<std::vector<int>>{{3}});
+      REQUIRE(client.IsConnected({{0, 3}, {3, 0}}) == std::vector<bool>{true, false});
+    }
+
+    server.Stop();
+    runner.join();
+  }
+
+  GIVEN("A regular file where the server's socket should go") {
+    gdwg::Graph<int, double> g;
+    auto shared = Shared::Create(Unique("/gdwg_query_file_"), g);
+    auto path = "/tmp/" + Unique("gdwg_query_file_") + ".sock";
+    std::ofstream{path} << "keep me";
+    THEN("The server refuses to start and leaves the file alone") {
+      REQUIRE_THROWS_WITH((gdwg::QueryServer<int, double>{shared, path}),
+                          "Cannot call QueryServer::QueryServer on " + path +
+                              ": it exists and is not a socket");
+      std::string contents;
+      std::getline(std::ifstream{path}, contents);
+      REQUIRE(contents == "keep me");
+    }
+    ::unlink(path.c_str());
+  }
+}